@@ -0,0 +1,187 @@
+// Load generator for the query server: closed-loop clients over a Unix socket, reporting QPS and latency percentiles
+//
+// Build from the src folder:
+//   g++ -std=c++17 -O2 -pthread -I../include -o query_loadgen ../bench/QueryLoadGen.cpp
+// Run (with the server started as ./main -s /tmp/weather.sock):
+//   ./query_loadgen /tmp/weather.sock [-c CONNECTIONS] [-d SECONDS] [-q QUERY]...
+//   Each connection sends one query, waits for its response line, and sends the next, cycling through
+//   the queries (a default mix of candles, hist, forecast and window queries without -q).
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Latencies (microseconds) and error count of one query text
+     */
+    struct Samples {
+        std::vector<double> latencies;
+        size_t errors = 0;
+    };
+
+    int connectTo(const std::string& path)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            return -1;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd != -1 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+            ::close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    /**
+     * @brief Send a request line and read its response line; false if the connection failed
+     */
+    bool roundTrip(int fd, const std::string& request, std::string& buffer, std::string& response)
+    {
+        size_t sent = 0;
+        while (sent < request.size()) {
+            ssize_t n = ::send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        char chunk[64 * 1024];
+        size_t newline;
+        while ((newline = buffer.find('\n')) == std::string::npos) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        response.assign(buffer, 0, newline);
+        buffer.erase(0, newline + 1);
+        return true;
+    }
+
+    /**
+     * @brief Latency at quantile q (0..1) of sorted samples, nearest rank
+     */
+    double percentile(const std::vector<double>& sorted, double q)
+    {
+        if (sorted.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    void printRow(const std::string& name, std::vector<double> latencies, size_t errors, double seconds)
+    {
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << std::left << std::setw(44) << name.substr(0, 43) << std::right
+                  << std::setw(9) << latencies.size()
+                  << std::setw(7) << errors
+                  << std::setw(10) << std::fixed << std::setprecision(1) << latencies.size() / seconds
+                  << std::setw(10) << std::setprecision(3) << percentile(latencies, 0.50) / 1000.0
+                  << std::setw(10) << percentile(latencies, 0.99) / 1000.0
+                  << std::setw(10) << (latencies.empty() ? 0.0 : latencies.back()) / 1000.0 << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argv[1][0] == '-') {
+        std::cerr << "Usage: " << argv[0] << " SOCKET [-c CONNECTIONS] [-d SECONDS] [-q QUERY]...\n";
+        return 2;
+    }
+    std::string path = argv[1];
+    unsigned connections = 4;
+    double duration = 5.0;
+    std::vector<std::string> queries;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "-c") {
+            connections = static_cast<unsigned>(std::max(1L, std::strtol(argv[i + 1], nullptr, 10)));
+        } else if (option == "-d") {
+            duration = std::max(0.1, std::strtod(argv[i + 1], nullptr));
+        } else if (option == "-q") {
+            queries.push_back(argv[i + 1]);
+        } else {
+            std::cerr << "Unknown option " << option << "\n";
+            return 2;
+        }
+    }
+    if (queries.empty()) {
+        queries = {"candles DE yearly", "candles FR month", "hist FR max", "hist GB median month",
+                   "forecast GB 10", "forecast DE 12 month hw", "window DE 2019-01-01 2019-01-31"};
+    }
+
+    // Every connection keeps its own samples; they are merged once the clients stop
+    std::vector<std::vector<Samples>> samples(connections, std::vector<Samples>(queries.size()));
+    std::atomic<bool> failed(false);
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration));
+    std::vector<std::thread> clients;
+    for (unsigned c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c] {
+            int fd = connectTo(path);
+            if (fd == -1) {
+                failed = true;
+                return;
+            }
+            std::string buffer;
+            std::string response;
+            for (size_t n = c; Clock::now() < deadline; ++n) {
+                size_t q = n % queries.size();
+                Clock::time_point sent = Clock::now();
+                if (!roundTrip(fd, queries[q] + "\n", buffer, response)) {
+                    failed = true;
+                    break;
+                }
+                double micros = std::chrono::duration<double, std::micro>(Clock::now() - sent).count();
+                samples[c][q].latencies.push_back(micros);
+                if (response.compare(0, 10, "{\"ok\":true") != 0) {
+                    ++samples[c][q].errors;
+                }
+            }
+            ::close(fd);
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (failed) {
+        std::cerr << "Warning: some connections to " << path << " failed or were closed early\n";
+    }
+
+    std::cout << connections << " connections, " << std::fixed << std::setprecision(1) << seconds << " s\n";
+    std::cout << std::left << std::setw(44) << "Query" << std::right << std::setw(9) << "Requests" << std::setw(7)
+              << "Errors" << std::setw(10) << "QPS" << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms"
+              << std::setw(10) << "max ms" << "\n";
+    std::vector<double> all;
+    size_t allErrors = 0;
+    for (size_t q = 0; q < queries.size(); ++q) {
+        std::vector<double> latencies;
+        size_t errors = 0;
+        for (unsigned c = 0; c < connections; ++c) {
+            latencies.insert(latencies.end(), samples[c][q].latencies.begin(), samples[c][q].latencies.end());
+            errors += samples[c][q].errors;
+        }
+        all.insert(all.end(), latencies.begin(), latencies.end());
+        allErrors += errors;
+        printRow(queries[q], latencies, errors, seconds);
+    }
+    printRow("All", all, allErrors, seconds);
+    return failed ? 1 : 0;
+}
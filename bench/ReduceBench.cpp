@@ -0,0 +1,124 @@
+// Microbenchmark: yearly sum/count/min/max per row through a hash map vs. ReduceKernels over year runs (scalar / AVX2)
+//
+// Build from the src folder:
+//   g++ -std=c++17 -O2 -pthread -I../include -o reduce_bench ../bench/ReduceBench.cpp ReduceKernels.cpp CpuFeatures.cpp WeatherRollup.cpp TimeUtils.cpp Parallel.cpp WeatherTable.cpp WeatherSchema.cpp CSVReader.cpp CSVScanner.cpp MappedCSV.cpp MappedFile.cpp NumberParser.cpp TDigest.cpp
+// Run:
+//   ./reduce_bench [file.csv]   (without a file, 40 years of hourly synthetic readings are used)
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "ReduceKernels.h"
+#include "TimeUtils.h"
+#include "WeatherRollup.h"
+#include "WeatherTable.h"
+
+namespace {
+    /**
+     * @brief Hourly readings from 1980 with every 50th value missing
+     */
+    void makeSyntheticColumn(size_t hours, std::vector<int64_t>& timestamps, std::vector<double>& values)
+    {
+        int64_t start = TimeUtils::toEpoch(1980, 1, 1);
+        for (size_t i = 0; i < hours; ++i) {
+            timestamps.push_back(start + static_cast<int64_t>(i) * 3600);
+            values.push_back(i % 50 == 7 ? std::numeric_limits<double>::quiet_NaN()
+                                         : 10.0 + 12.0 * std::sin(i * 0.000717) + (i % 24) * 0.25);
+        }
+    }
+
+    /**
+     * @brief The pre-kernel loop: one hash-map update and one year lookup per row
+     */
+    double runHashMap(const int64_t* timestamps, const double* values, size_t rows)
+    {
+        std::unordered_map<int, ReduceKernels::Summary> years;
+        for (size_t i = 0; i < rows; ++i) {
+            if (std::isnan(values[i])) {
+                continue;
+            }
+            ReduceKernels::Summary& summary = years[TimeUtils::yearOf(timestamps[i])];
+            summary.sum += values[i];
+            ++summary.count;
+            summary.min = std::min(summary.min, values[i]);
+            summary.max = std::max(summary.max, values[i]);
+        }
+        double total = 0.0;
+        for (const auto& entry : years) {
+            total += entry.second.sum;
+        }
+        return total;
+    }
+
+    double runKernels(const std::vector<WeatherRollup::Run>& runs, const double* values, ReduceKernels::Implementation impl)
+    {
+        double total = 0.0;
+        for (const WeatherRollup::Run& run : runs) {
+            ReduceKernels::Summary summary;
+            ReduceKernels::reduce(impl, values + run.begin, run.end - run.begin, summary);
+            total += summary.sum;
+        }
+        return total;
+    }
+
+    template <typename Fn>
+    void report(const char* name, size_t rows, int repeats, Fn fn, double baselineMs, double& elapsedMs)
+    {
+        double total = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; ++i) {
+            total = fn();
+        }
+        auto stop = std::chrono::steady_clock::now();
+        elapsedMs = std::chrono::duration<double, std::milli>(stop - start).count() / repeats;
+
+        std::cout << std::left << std::setw(10) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(3) << elapsedMs << " ms"
+                  << std::setw(10) << std::setprecision(2) << elapsedMs * 1e6 / rows << " ns/row"
+                  << std::setw(8) << std::setprecision(2) << (baselineMs > 0.0 ? baselineMs / elapsedMs : 1.0) << "x"
+                  << "   sum=" << std::setprecision(1) << total << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    WeatherTable table;
+    std::vector<int64_t> syntheticTimestamps;
+    std::vector<double> syntheticValues;
+    const int64_t* timestamps = nullptr;
+    const double* values = nullptr;
+    size_t rows = 0;
+    bool ascending = true;
+    if (argc > 1) {
+        if (!table.load(argv[1]) || table.columnCount() == 0) {
+            return 1;
+        }
+        timestamps = table.timestamps();
+        values = table.column(0);
+        rows = table.rowCount();
+        ascending = table.timestampsAscending();
+    } else {
+        makeSyntheticColumn(40 * 8766, syntheticTimestamps, syntheticValues);
+        timestamps = syntheticTimestamps.data();
+        values = syntheticValues.data();
+        rows = syntheticValues.size();
+    }
+
+    const int repeats = 20;
+    std::vector<WeatherRollup::Run> runs =
+        WeatherRollup::periodRuns(timestamps, 0, rows, WeatherRollup::Granularity::Year, ascending);
+    std::cout << "Rows: " << rows << ", year runs: " << runs.size() << ", best kernel: "
+              << ReduceKernels::implementationName(ReduceKernels::bestImplementation()) << "\n\n";
+
+    double baselineMs = 0.0;
+    double elapsedMs = 0.0;
+    report("hashmap", rows, repeats, [&] { return runHashMap(timestamps, values, rows); }, 0.0, baselineMs);
+    report("scalar", rows, repeats, [&] { return runKernels(runs, values, ReduceKernels::Implementation::Scalar); }, baselineMs, elapsedMs);
+    report("avx2", rows, repeats, [&] { return runKernels(runs, values, ReduceKernels::Implementation::AVX2); }, baselineMs, elapsedMs);
+    return 0;
+}
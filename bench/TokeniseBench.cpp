@@ -0,0 +1,117 @@
+// Microbenchmark: CSVReader::tokenise vs. CSVScanner::splitLine (scalar / SSE2 / AVX2)
+//
+// Build from the src folder:
+//   g++ -std=c++17 -O2 -pthread -I../include -o tokenise_bench ../bench/TokeniseBench.cpp CSVReader.cpp CSVScanner.cpp CpuFeatures.cpp MappedCSV.cpp MappedFile.cpp
+// Run:
+//   ./tokenise_bench [file.csv]   (without a file, 60-column synthetic rows are used)
+// Both sides report the number of fields, which agree on CRLF input too: only the last
+// field's contents differ, since splitLine drops the '\r' and tokenise keeps it.
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CSVReader.h"
+#include "CSVScanner.h"
+
+namespace {
+    /**
+     * @brief Build rows shaped like weather_data.csv: a timestamp and 60 numeric cells
+     */
+    std::string makeSyntheticCSV(int rows)
+    {
+        std::string text;
+        char cell[32];
+        for (int r = 0; r < rows; ++r) {
+            std::snprintf(cell, sizeof(cell), "19%02d-01-01T%02d:00:00Z", 80 + r % 20, r % 24);
+            text += cell;
+            for (int c = 0; c < 60; ++c) {
+                std::snprintf(cell, sizeof(cell), ",%.3f", (r * 7 + c * 13) % 4000 / 100.0 - 10.0);
+                text += cell;
+            }
+            text += '\n';
+        }
+        return text;
+    }
+
+    /**
+     * @brief Split the text line by line, the way the loaders do, and return fields seen
+     */
+    size_t runScanner(std::string_view text, CSVScanner::Implementation impl)
+    {
+        std::vector<std::string_view> fields;
+        size_t total = 0;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            pos += CSVScanner::splitLine(impl, text.data() + pos, text.size() - pos, ',', fields) + 1;
+            total += fields.size();
+        }
+        return total;
+    }
+
+    size_t runTokenise(std::string_view text)
+    {
+        size_t total = 0;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            if (nl == std::string_view::npos) {
+                nl = text.size();
+            }
+            total += CSVReader::tokenise(std::string(text.substr(pos, nl - pos)), ',').size();
+            pos = nl + 1;
+        }
+        return total;
+    }
+
+    template <typename Fn>
+    void report(const char* name, std::string_view text, int repeats, Fn fn, double baselineMs, double& elapsedMs)
+    {
+        size_t fields = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; ++i) {
+            fields = fn();
+        }
+        auto stop = std::chrono::steady_clock::now();
+        elapsedMs = std::chrono::duration<double, std::milli>(stop - start).count() / repeats;
+
+        double mbPerSec = (text.size() / (1024.0 * 1024.0)) / (elapsedMs / 1000.0);
+        std::cout << std::left << std::setw(10) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(2) << elapsedMs << " ms"
+                  << std::setw(10) << std::setprecision(1) << mbPerSec << " MB/s"
+                  << std::setw(8) << std::setprecision(2) << (baselineMs > 0.0 ? baselineMs / elapsedMs : 1.0) << "x"
+                  << "   fields=" << fields << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    MappedCSV csv;
+    std::string synthetic;
+    std::string_view text;
+    if (argc > 1) {
+        if (!csv.open(argv[1])) {
+            return 1;
+        }
+        text = csv.text();
+    } else {
+        synthetic = makeSyntheticCSV(50000);
+        text = synthetic;
+    }
+
+    const int repeats = 3;
+    std::cout << "Input: " << text.size() / (1024.0 * 1024.0) << " MB, best scanner: "
+              << CSVScanner::implementationName(CSVScanner::bestImplementation()) << "\n\n";
+
+    double baselineMs = 0.0;
+    double elapsedMs = 0.0;
+    report("tokenise", text, repeats, [&] { return runTokenise(text); }, 0.0, baselineMs);
+    report("scalar", text, repeats, [&] { return runScanner(text, CSVScanner::Implementation::Scalar); }, baselineMs, elapsedMs);
+    report("sse2", text, repeats, [&] { return runScanner(text, CSVScanner::Implementation::SSE2); }, baselineMs, elapsedMs);
+    report("avx2", text, repeats, [&] { return runScanner(text, CSVScanner::Implementation::AVX2); }, baselineMs, elapsedMs);
+    return 0;
+}
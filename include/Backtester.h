@@ -0,0 +1,66 @@
+#ifndef BACKTESTER_H
+#define BACKTESTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Forecaster.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Rolling-origin cross-validation of the forecast models.
+ *        For every cutoff period each series is cut into a training prefix
+ *        and the `horizon` periods that follow; each model is fitted on the
+ *        prefix and scored on what actually came next. Folds never copy or
+ *        re-aggregate data: they are views into the shared period series, the
+ *        linear trend of a prefix is read from cumulative regression moments
+ *        in O(1), and every Holt-Winters / ARIMA fold of every series is a
+ *        separate task on the pool.
+ */
+class Backtester {
+public:
+    enum class Model {
+        SeasonalNaive, // Same period one season earlier (last value without a season)
+        Linear,        // Least-squares trend of the prefix
+        HoltWinters,
+        ARIMA
+    };
+    static const size_t MODEL_COUNT = 4;
+
+    /**
+     * @brief Accumulated forecast errors of one model
+     */
+    struct Score {
+        size_t count;
+        double absoluteError; // Sum of |error|
+        double squaredError;  // Sum of error^2
+
+        Score();
+
+        void add(double error);
+        void merge(const Score& other);
+        double mae() const;
+        double rmse() const;
+    };
+
+    /**
+     * @brief Scores of every series, scores[series][model], and how many folds each had;
+     *        every model of a series is scored on the same folds
+     */
+    struct Report {
+        std::vector<std::vector<Score>> scores;
+        std::vector<size_t> folds;
+        size_t dropped = 0; // Folds left out because Holt-Winters or ARIMA could not fit them
+    };
+
+    // Backtest every series (values[0] is period firstPeriods[i]) at each cutoff period:
+    // train on the periods before the cutoff, forecast `horizon` periods from it. Folds whose
+    // prefix is shorter than three periods or whose horizon runs past the data are skipped,
+    // and so are folds that Holt-Winters or ARIMA cannot fit, for all models alike.
+    static Report run(const std::vector<std::vector<double>>& series, const std::vector<int64_t>& firstPeriods,
+                      const std::vector<int64_t>& cutoffs, int horizon, int seasonLength, ThreadPool& pool);
+
+    static const char* modelName(Model model);
+};
+
+#endif // BACKTESTER_H
@@ -0,0 +1,74 @@
+#ifndef BATCHQUERY_H
+#define BATCHQUERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Forecaster.h"
+#include "WeatherRollup.h"
+
+/**
+ * @brief One query of the non-interactive batch mode, parsed from a line of
+ *        blank-separated words. Keywords are case-insensitive and optional
+ *        words may come in any order:
+ *          candles  CC [granularity]
+ *          hist     CC [mean|max|min|median|pN] [granularity]
+ *          forecast CC N [granularity] [linear|hw|arima|best]
+ *          window   CC FROM TO     (YYYY-MM-DD or YYYY-MM-DDTHH:MM:SS, TO inclusive)
+ *        The granularity defaults to year, hist to the mean and forecast to
+ *        the linear trend.
+ */
+class BatchQuery {
+public:
+    enum class Kind {
+        Candles,
+        Histogram,
+        Forecast,
+        Window
+    };
+
+    Kind kind;
+    std::string text;      // The query's words joined by single blanks, echoed above its result
+    std::string country;
+    WeatherRollup::Granularity granularity;
+    int dataType;          // Histogram: 1=Average, 2=Max, 3=Min, 4=Median, 7=percentile
+    double percentile;
+    int periods;           // Forecast: number of future periods
+    bool linear;           // Forecast: linear trend instead of `method`
+    Forecaster::Method method;
+    int64_t from;          // Window: [from, to) in epoch seconds
+    int64_t to;
+
+    /**
+     * @brief Answer to a query: rows of a label (period, or reading count for a
+     *        window) followed by numbers
+     */
+    struct Result {
+        std::string model;                // Forecasts: the fitted model, e.g. "ARIMA(1,1,1) m=12 (RMSE ...)"
+        std::vector<std::string> columns; // The first one names the labels
+        std::vector<std::string> labels;  // One per row
+        std::vector<double> values;       // Row-major, columns.size() - 1 per row
+    };
+
+    BatchQuery();
+
+    // Parse one query; on failure `error` says what is wrong and false is returned
+    static bool parse(const std::string& line, BatchQuery& query, std::string& error);
+
+    // Tab-separated table under a "# query" line (and a "# model: ..." line), numbers to 3 decimals
+    std::string formatText(const Result& result) const;
+    // One JSON object on one line: {"ok":true,"query":...,"columns":[...],"rows":[[label,numbers...],...]}
+    // with numbers in shortest round-trip form and NaN as null
+    std::string formatJSON(const Result& result) const;
+    // {"ok":false,"query":...,"error":...} on one line
+    static std::string formatError(const std::string& query, const std::string& error);
+
+    // Queries of a file or argument list: one per line or per ';', '#' starts a comment
+    static std::vector<std::string> split(const std::string& text);
+
+    // Largest forecast horizon: 27 years of days, so one request cannot exhaust memory
+    static const int MAX_PERIODS = 10000;
+};
+
+#endif // BATCHQUERY_H
@@ -3,12 +3,22 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <utility>
+#include "MappedCSV.h"
 
 class CSVReader {
 public:
     // Read CSV file and return data as a 2D vector
     static std::vector<std::vector<std::string>> readCSV(const std::string& filename);
 
+    // Split text into at most `parts` [begin, end) byte ranges, each ending just after a newline;
+    // WeatherTable parses one range per worker
+    static std::vector<std::pair<size_t, size_t>> splitLines(std::string_view text, unsigned parts);
+
+    // Map CSV file into memory and return zero-copy row views
+    static MappedCSV mapCSV(const std::string& filename);
+
     // Tokenise a string based on a delimiter
     static std::vector<std::string> tokenise(const std::string& str, char delimiter);
 };
@@ -0,0 +1,41 @@
+#ifndef CSVSCANNER_H
+#define CSVSCANNER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Vectorised field splitter.
+ *        Compares 16 (SSE2) or 32 (AVX2) bytes at a time against the delimiter
+ *        and '\n', then turns the match bitmasks into field offsets.
+ *        The implementation is chosen once at runtime; a scalar loop is the fallback.
+ */
+class CSVScanner {
+public:
+    enum class Implementation { Scalar, SSE2, AVX2 };
+
+    // Best implementation supported by the running CPU
+    static Implementation bestImplementation();
+    static const char* implementationName(Implementation impl);
+
+    // Split the line starting at data into fields. Scanning stops at the first '\n'
+    // or after `length` bytes. A trailing empty field is dropped, as CSVReader::tokenise
+    // does; a trailing '\r' is also dropped, whereas tokenise keeps it on the last field.
+    // Returns the line length, excluding the '\n'.
+    static size_t splitLine(const char* data, size_t length, char delimiter,
+                            std::vector<std::string_view>& fields);
+
+    // Same as above with an explicit implementation (used by the benchmark)
+    static size_t splitLine(Implementation impl, const char* data, size_t length, char delimiter,
+                            std::vector<std::string_view>& fields);
+
+    // Offset just past the `count`-th delimiter of the line starting at data, or npos
+    // if the line (ending at '\n' or after `length` bytes) has fewer delimiters.
+    // Used to jump to one field without splitting the others.
+    static size_t skipFields(const char* data, size_t length, char delimiter, size_t count);
+
+    static const size_t npos = static_cast<size_t>(-1);
+};
+
+#endif // CSVSCANNER_H
@@ -1,17 +1,23 @@
 #ifndef CANDLESTICK_H
 #define CANDLESTICK_H
 
+#include <cstdint>
 #include <string>
+#include "WeatherRollup.h"
 
 class Candlestick {
 public:
-    std::string date; // "YYYY" format
+    int64_t period;                        // Period key (see WeatherRollup::periodOf), e.g. the year
+    WeatherRollup::Granularity granularity; // Unit of `period`
     double open;
     double high;
     double low;
     double close;
 
-    Candlestick(const std::string& date_, double open_, double high_, double low_, double close_);
+    Candlestick(int64_t period_, WeatherRollup::Granularity granularity_, double open_, double high_, double low_, double close_);
+
+    // Display label: "YYYY", "YYYY-MM" or "YYYY-MM-DD"
+    std::string label() const;
 };
 
 #endif // CANDLESTICK_H
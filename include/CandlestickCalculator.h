@@ -2,6 +2,9 @@
 #define CANDLESTICKCALCULATOR_H
 
 #include "Candlestick.h"
+#include "WeatherRollup.h"
+#include "WeatherTable.h"
+#include <map>
 #include <vector>
 #include <string>
 
@@ -9,6 +12,15 @@ class CandlestickCalculator {
 public:
     // get CSV data and country code, return candlestick data
     static std::vector<Candlestick> computeCandlestickData(const std::vector<std::vector<std::string>>& csvData, const std::string& countryCode);
+
+    // Candlesticks at any rollup granularity, read from the pre-aggregated level
+    // (no row is touched). The country's temperature column must be in the rollup.
+    static std::vector<Candlestick> computeCandlestickData(const WeatherTable& table, const WeatherRollup& rollup,
+                                                           const std::string& countryCode, WeatherRollup::Granularity granularity);
+
+    // Yearly candlesticks for every country with a temperature column, keyed by
+    // country code. One scan over the rows; row blocks run on `workers` threads.
+    static std::map<std::string, std::vector<Candlestick>> computeAllCandlestickData(const WeatherTable& table, unsigned workers = 0);
 };
 
 #endif // CANDLESTICKCALCULATOR_H
@@ -0,0 +1,14 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+/**
+ * @brief Runtime CPU feature detection used to pick SIMD kernels.
+ *        Always false on non-x86 builds, which then use the scalar code.
+ */
+class CpuFeatures {
+public:
+    static bool hasSSE2();
+    static bool hasAVX2();
+};
+
+#endif // CPUFEATURES_H
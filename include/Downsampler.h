@@ -0,0 +1,33 @@
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <cstddef>
+#include <vector>
+#include "Candlestick.h"
+
+/**
+ * @brief Reduce a series to the number of columns a chart can show, in one
+ *        O(n) pass, so any length fits the terminal.
+ *        - lttb: Largest-Triangle-Three-Buckets for line charts; keeps the
+ *          points that shape the line
+ *        - minMax: lowest and highest point of each bucket for bar charts, so
+ *          the extremes survive
+ *        - candles: consecutive candlesticks merged, keeping open, close,
+ *          high and low exact
+ */
+class Downsampler {
+public:
+    // Indices (ascending) of at most `threshold` points chosen by LTTB; the first and last
+    // points are always kept. Every index is returned when count <= threshold.
+    static std::vector<size_t> lttb(const double* x, const double* y, size_t count, size_t threshold);
+
+    // Indices (ascending) of the minimum and maximum of each of `buckets` equal slices,
+    // at most 2 * buckets in total. Every index is returned when count <= 2 * buckets.
+    static std::vector<size_t> minMax(const double* y, size_t count, size_t buckets);
+
+    // At most maxCount candles: each merges a run of consecutive candles (open of the first,
+    // close of the last, highest high, lowest low) and carries the first one's period
+    static std::vector<Candlestick> candles(const std::vector<Candlestick>& candles, size_t maxCount);
+};
+
+#endif // DOWNSAMPLER_H
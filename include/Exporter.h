@@ -0,0 +1,106 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Streaming writer of tabular results (candlesticks, period values,
+ *        forecasts, raw readings) to a file.
+ *        Records are written field by field as they are produced: numbers are
+ *        formatted with std::to_chars (shortest round-trip form) into a 1 MiB
+ *        buffer that goes to the file in large writes, so nothing is held
+ *        beyond one buffer (or one block in the binary format).
+ *
+ * Formats:
+ *   CSV         header line, then one line per record; NaN is an empty field
+ *   JSON lines  one object per record; NaN is null
+ *   Binary      columnar, native byte order:
+ *                 magic "WXCOLS01", uint32 column count,
+ *                 per column: uint8 type (0 int64, 1 double, 2 text),
+ *                             uint16 name length + name bytes
+ *                 blocks of up to BLOCK_ROWS records: uint32 row count, then per
+ *                 column its values in order (int64 or double arrays; text as
+ *                 uint16 length + bytes per value)
+ *                 a block with row count 0 ends the file
+ */
+class Exporter {
+public:
+    enum class Format {
+        CSV,
+        JSONLines,
+        Binary
+    };
+
+    enum class Type {
+        Integer,
+        Real,
+        Text
+    };
+
+    /**
+     * @brief Name and value type of one field of every record
+     */
+    struct Column {
+        std::string name;
+        Type type;
+    };
+
+    Exporter();
+    ~Exporter();
+
+    Exporter(const Exporter&) = delete;
+    Exporter& operator=(const Exporter&) = delete;
+
+    // Create (truncate) the file and write the header. Returns false if it cannot be opened.
+    bool open(const std::string& filename, Format format, const std::vector<Column>& columns);
+
+    // Next field of the current record; fields come in column order with matching types
+    void integer(int64_t value);
+    void real(double value);
+    void text(std::string_view value);
+    // Finish the current record
+    void endRecord();
+
+    // Write what is buffered and close; false if any write failed
+    bool close();
+
+    size_t records() const { return recordCount; }
+    uint64_t bytesWritten() const { return written; }
+
+    // "csv", "jsonl"/"json" or "bin"/"binary"
+    static bool parseFormat(const std::string& text, Format& format);
+    // File extension of a format, without the dot
+    static const char* extension(Format format);
+
+    static const size_t BLOCK_ROWS = 65536;
+
+private:
+    // Start of a field in text formats: separator, and the key in JSON lines
+    void beginField();
+    void append(const char* data, size_t size);
+    void appendRaw(const void* data, size_t size) { append(static_cast<const char*>(data), size); }
+    void flush();
+    // Binary format: write the buffered block of columns
+    void writeBlock();
+
+    std::ofstream out;
+    Format format;
+    std::vector<Column> columns;
+    std::vector<char> buffer;
+    size_t used;
+    size_t field;         // Index of the next field in the current record
+    size_t recordCount;
+    uint64_t written;
+    bool failed;
+
+    // Binary format: one growing array per column for the current block
+    std::vector<std::vector<char>> blockColumns;
+    size_t blockRows;
+};
+
+#endif // EXPORTER_H
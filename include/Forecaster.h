@@ -0,0 +1,75 @@
+#ifndef FORECASTER_H
+#define FORECASTER_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+#include "WeatherRollup.h"
+
+/**
+ * @brief Holt-Winters and ARIMA forecasts of evenly spaced period series
+ *        - Holt-Winters: additive level, trend and season, smoothing
+ *          parameters chosen by grid search on the one-step squared error
+ *        - ARIMA(p,d,q): conditional sum of squares on the series with its
+ *          per-season means removed, minimised by Nelder-Mead; d comes from a
+ *          KPSS test, then the (p, q) with the lowest AIC at that d wins
+ *        Each likelihood evaluation is one O(n) recursion over buffers that
+ *        are allocated once per candidate, not per evaluation. The candidates
+ *        (one Holt-Winters alpha row or one ARIMA order) of every series are
+ *        independent ThreadPool tasks, so many countries are fitted at once.
+ */
+class Forecaster {
+public:
+    enum class Method {
+        HoltWinters,
+        ARIMA,
+        Best  // Whichever of the two has the lower AIC
+    };
+
+    /**
+     * @brief Chosen model of one series and its forecast
+     */
+    struct Result {
+        bool valid;
+        Method method;               // HoltWinters or ARIMA
+        std::string model;           // e.g. "HW(a=0.30,b=0.05,g=0.20)", "ARIMA(1,1,1)"
+        double rmse;                 // In-sample one-step-ahead error
+        double aic;
+        std::vector<double> forecast; // forecast[h] is h + 1 periods after the last value
+
+        Result();
+    };
+
+    /**
+     * @brief Read-only view of values[0, count); e.g. a training prefix of a longer series
+     */
+    struct Span {
+        const double* values;
+        size_t count;
+    };
+
+    // Season length of a granularity: 12 months, 52 weeks, 365 days, none (1) for years
+    static int seasonLength(WeatherRollup::Granularity granularity);
+
+    // Evenly spaced values from (period, value) pairs sorted by period; interior gaps are
+    // filled by linear interpolation. values[0] is points.front().first.
+    static std::vector<double> fillGaps(const std::vector<std::pair<int, double>>& points);
+
+    // Fit every series concurrently on the pool and forecast `horizon` periods of each
+    static std::vector<Result> forecastAll(const std::vector<std::vector<double>>& series, int seasonLength,
+                                           Method method, int horizon, ThreadPool& pool);
+
+    // Same, on views into series owned by the caller (kept alive until this returns)
+    static std::vector<Result> forecastAll(const std::vector<Span>& series, int seasonLength,
+                                           Method method, int horizon, ThreadPool& pool);
+
+    // Single-series form of forecastAll (its candidates still run on the pool)
+    static Result forecast(const std::vector<double>& series, int seasonLength, Method method, int horizon,
+                           ThreadPool& pool);
+
+    static const char* methodName(Method method);
+};
+
+#endif // FORECASTER_H
@@ -0,0 +1,68 @@
+#ifndef MAPPEDCSV_H
+#define MAPPEDCSV_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MappedFile.h"
+
+/**
+ * @brief A single CSV line viewed in place.
+ *        Fields are located on demand by scanning for the delimiter,
+ *        so no per-cell storage is ever allocated.
+ */
+class CSVRow {
+public:
+    explicit CSVRow(std::string_view line_, char delimiter_ = ',');
+
+    // The raw line without its line terminator
+    std::string_view text() const { return line; }
+
+    // Number of fields (a trailing empty field is ignored, like CSVReader::tokenise)
+    size_t size() const;
+    bool empty() const { return line.empty(); }
+
+    // Field at the given index, or an empty view if the row is too short
+    std::string_view operator[](size_t index) const;
+
+    // Split every field into a caller-owned buffer (the buffer is reused, not reallocated)
+    void split(std::vector<std::string_view>& fields) const;
+
+private:
+    std::string_view line;
+    char delimiter;
+};
+
+/**
+ * @brief Read-only, memory-mapped CSV file.
+ *        Only the byte offset of each line is stored; rows are returned as
+ *        CSVRow views into the mapping.
+ */
+class MappedCSV {
+public:
+    MappedCSV();
+
+    // Map the file and index its lines. Returns false if the file cannot be opened.
+    bool open(const std::string& filename);
+    void close();
+
+    bool empty() const { return rowCount() == 0; }
+    size_t size() const { return rowCount(); }
+    size_t rowCount() const { return lineStarts.empty() ? 0 : lineStarts.size() - 1; }
+
+    CSVRow operator[](size_t row) const;
+
+    // Whole file contents
+    std::string_view text() const { return file.text(); }
+
+private:
+    void indexLines();
+
+    MappedFile file;
+
+    // lineStarts[i] is the byte offset of line i; the final entry marks the end
+    std::vector<size_t> lineStarts;
+};
+
+#endif // MAPPEDCSV_H
@@ -0,0 +1,38 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *        Falls back to reading the file into memory when it cannot be mapped
+ *        (empty file, pipe, ...), so callers always see one contiguous buffer.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file. Returns false if it cannot be opened.
+    bool open(const std::string& filename);
+    void close();
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    std::string_view text() const { return std::string_view(bytes, length); }
+
+private:
+    const char* bytes;
+    size_t length;
+    bool mapped;        // true when bytes points into an mmap region
+    std::string buffer; // fallback storage when the file cannot be mapped
+};
+
+#endif // MAPPEDFILE_H
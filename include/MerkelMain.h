@@ -3,7 +3,15 @@
 
 #include <vector>
 #include <string>
+#include "BatchQuery.h"
 #include "Candlestick.h"
+#include "Forecaster.h"
+#include "RangeIndex.h"
+#include "RegressionEngine.h"
+#include "SeriesCache.h"
+#include "ThreadPool.h"
+#include "WeatherRollup.h"
+#include "WeatherTable.h"
 
 /**
  * @brief Main class
@@ -15,11 +23,22 @@
 class MerkelMain
 {
 public:
-    // Constructor
-    MerkelMain();
+    // Constructor; workerCount threads are used for loading (0 = one per core).
+    // A non-empty `countries` (a batch that queries only those) lets a start without a fresh
+    // cache parse just their temperature columns; only they are aggregated and queryable.
+    explicit MerkelMain(unsigned workerCount = 0, const std::string& dataFilename = "../weather_data.csv",
+                        const std::vector<std::string>& countries = {});
 
     // Start main loop
     void init();
+
+    // Run queries (see BatchQuery) without prompts or menus; results go to stdout in query
+    // order, errors to stderr. Returns the number of queries that failed.
+    size_t runBatch(const std::vector<std::string>& queries);
+
+    // Keep the data resident and answer queries from clients of a Unix socket, one JSON line
+    // per request line, on `threads` threads until SIGINT/SIGTERM. False if it cannot listen.
+    bool serve(const std::string& socketPath, unsigned threads);
 private:
     // Display menu
     void printMenu();
@@ -33,8 +52,19 @@ private:
     // Get country code from user
     std::string getCountryCodeFromUser();
 
-    // Compute Candlestick from CSV data
-    std::vector<Candlestick> computeCandlestickDataForCountry(const std::string& countryCode);
+    // Get candle/histogram/regression granularity from user (empty input = yearly)
+    WeatherRollup::Granularity getGranularityFromUser();
+
+    // Compute Candlestick from the rollup of the loaded weather table (cached per query)
+    std::vector<Candlestick> computeCandlestickDataForCountry(const std::string& countryCode,
+                                                              WeatherRollup::Granularity granularity = WeatherRollup::Granularity::Year);
+
+    // (period, value) of every non-empty period of a country's `column`. dataType 1=Average,
+    // 2=Max, 3=Min are read from the rollup buckets; 4..7 are the `percentile` of a
+    // per-period quantile sketch. Results are cached per query.
+    std::vector<std::pair<int, double>> collectPeriodValues(const std::string& countryCode, int column,
+                                                            WeatherRollup::Granularity granularity, int dataType,
+                                                            double percentile = 50.0);
 
     // ─────────────────────────────────────────────
     // (1) Compute and Display Candlestick Data (Menu 2)
@@ -49,6 +79,7 @@ private:
     // ─────────────────────────────────────────────
     // (3) Text-based Rendering of Computed Candlestick Data
     // ─────────────────────────────────────────────
+    // Longer series are merged into at most maxDisplayCount candles (fewer if the terminal is narrower)
     void plotCandlestickData(const std::vector<Candlestick>& candles, int maxDisplayCount);
 
     // ─────────────────────────────────────────────
@@ -56,15 +87,91 @@ private:
     // ─────────────────────────────────────────────
     void showYearlyHistogram();
 
-    // Existing function: Select 1=Average, 2=Max Temperature, 3=Min Temperature
-    int getDataTypeFromUser();
+    // Existing function: Select 1=Average, 2=Max Temperature, 3=Min Temperature,
+    // 4=Median, 5=10th, 6=90th or 7=any percentile (returned through `percentile`)
+    int getDataTypeFromUser(double& percentile);
 
     // ─────────────────────────────────────────────
     // (5) Predict future temperature
     // ─────────────────────────────────────────────
     void predictFutureTemperature();
 
-    void plotPrediction(const std::vector<std::pair<int, double>>& pastData, const std::vector<std::pair<int, double>>& predictedData) const;
+    // Line chart of past (blue) and predicted (green) points, thinned by LTTB to the terminal width
+    void plotPrediction(const std::vector<std::pair<int, double>>& pastData, const std::vector<std::pair<int, double>>& predictedData,
+                        WeatherRollup::Granularity granularity = WeatherRollup::Granularity::Year,
+                        const std::string& title = "Temperature Prediction Plot") const;
+
+    // Trend fits of every temperature column at a granularity, built on first use
+    const RegressionEngine& regressionFor(WeatherRollup::Granularity granularity);
+
+    // ─────────────────────────────────────────────
+    // (6) Yearly candlesticks for every country in one pass (Menu 6)
+    // ─────────────────────────────────────────────
+    void computeAllCountriesSummary();
+
+    // ─────────────────────────────────────────────
+    // (7) OHLC, min, max and mean over an arbitrary time window (Menu 7)
+    // ─────────────────────────────────────────────
+    void queryTimeWindow();
+
+    // OHLC, min, max and mean of a country column over [from, to) (cached per window)
+    RangeIndex::Stats windowStats(const std::string& countryCode, int column, int64_t from, int64_t to);
+
+    // Chart every hourly reading of a column in [from, to), thinned by LTTB to the terminal width
+    void plotWindowReadings(int column, int64_t from, int64_t to) const;
+
+    // ─────────────────────────────────────────────
+    // (8) Load rows appended to the CSV since start-up (Menu 8)
+    // ─────────────────────────────────────────────
+    void refreshData();
+
+    // ─────────────────────────────────────────────
+    // (9) Trend forecast for every country in one batch (Menu 9)
+    // ─────────────────────────────────────────────
+    void forecastAllCountries();
+
+    // ─────────────────────────────────────────────
+    // (10) Trend + annual/diurnal harmonics fitted on the hourly readings (Menu 10)
+    // ─────────────────────────────────────────────
+    void predictSeasonalTemperature();
+
+    // ─────────────────────────────────────────────
+    // (11) Holt-Winters / ARIMA forecast of one country (Menu 11)
+    // ─────────────────────────────────────────────
+    void forecastWithModels();
+
+    // ─────────────────────────────────────────────
+    // (12) Holt-Winters / ARIMA forecast report for every country (Menu 12)
+    // ─────────────────────────────────────────────
+    void forecastReportAllCountries();
+
+    // ─────────────────────────────────────────────
+    // (13) Rolling-origin backtest of every forecast model (Menu 13)
+    // ─────────────────────────────────────────────
+    void backtestForecastModels();
+
+    // ─────────────────────────────────────────────
+    // (14) Stream candlesticks, period values, forecasts or readings to a file (Menu 14)
+    // ─────────────────────────────────────────────
+    void exportData();
+
+    // Countries to export: one code, or every country with a temperature column for "all"
+    std::vector<std::string> getExportCountriesFromUser();
+
+    // Select 1=Holt-Winters, 2=ARIMA or 3=best of both (empty input = best); false on bad input
+    bool getForecastMethodFromUser(Forecaster::Method& method);
+
+    // Evenly spaced period means of a country column, gaps interpolated; firstPeriod is values[0]
+    std::vector<double> forecastSeries(const std::string& countryCode, int column,
+                                       WeatherRollup::Granularity granularity, int& firstPeriod);
+
+    // Answer one parsed query. Holt-Winters / ARIMA forecasts arrive already fitted
+    // (`model`, with lastPeriod its last observed period). Safe to call concurrently.
+    bool runBatchQuery(const BatchQuery& query, const Forecaster::Result& model, int lastPeriod,
+                       BatchQuery::Result& result, std::string& error);
+
+    // Server request: parse, fit if needed and answer one query line as a JSON line
+    std::string answerQuery(const std::string& line);
 
     // ─────────────────────────────────────────────
     // Member Variables
@@ -72,8 +179,35 @@ private:
     // Recently computed candlestick data
     std::vector<Candlestick> lastComputedCandles;
 
-    // Raw CSV data
-    std::vector<std::vector<std::string>> csvData;
+    // Worker threads used for parallel work
+    unsigned workerCount;
+
+    // Threads one query may start: 1 while queries already run side by side (server, batch)
+    unsigned queryWorkers;
+
+    // CSV file the table was loaded from; refreshData() reads what was appended to it
+    std::string dataFilename;
+
+    // CSV data parsed once into typed columns
+    WeatherTable weatherTable;
+
+    // Table columns holding temperatures, in header order
+    std::vector<size_t> temperatureColumns;
+
+    // Day/week/month/year aggregates of every temperature column, built at load time
+    WeatherRollup weatherRollup;
+
+    // Linear trends per granularity (indexed by Granularity), updated in place on refresh
+    RegressionEngine regressions[4];
+
+    // Time-window queries over weatherTable (per-column indexes built on first use)
+    WindowIndex windowIndex;
+
+    // Computed series keyed by query, checked by every analysis before it computes
+    SeriesCache seriesCache;
+
+    // Workers for many small model-fitting tasks (every candidate of every country)
+    ThreadPool forecastPool;
 };
 
 #endif // MERKELMAIN_H
@@ -0,0 +1,22 @@
+#ifndef NUMBERPARSER_H
+#define NUMBERPARSER_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Non-throwing numeric parsing for CSV cells.
+ *        Decimal numbers of up to 19 significant digits with a small exponent
+ *        take an exact fast path (mantissa times a power of ten); anything
+ *        longer is handed to strtod. The whole cell must be a number,
+ *        surrounding spaces are ignored.
+ */
+class NumberParser {
+public:
+    enum class Result { Ok, Empty, Invalid };
+
+    static Result parseDouble(std::string_view text, double& value);
+    static Result parseInt(std::string_view text, int64_t& value);
+};
+
+#endif // NUMBERPARSER_H
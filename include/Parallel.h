@@ -0,0 +1,26 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Minimal fork/join helpers shared by the loaders and calculators
+ */
+class Parallel {
+public:
+    // Resolve a requested worker count; 0 means "one per hardware thread"
+    static unsigned workerCount(unsigned requested);
+
+    // Run task(worker) for worker = 0..workers-1 concurrently and wait for all of them.
+    // The calling thread runs worker 0. If tasks throw, the first exception (by worker)
+    // is rethrown after every worker has finished.
+    static void run(unsigned workers, const std::function<void(unsigned)>& task);
+
+    // Split [0, count) into at most `parts` contiguous, near-equal ranges
+    static std::vector<std::pair<size_t, size_t>> splitRange(size_t count, unsigned parts);
+};
+
+#endif // PARALLEL_H
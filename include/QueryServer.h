@@ -0,0 +1,106 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Line protocol server on a Unix domain socket.
+ *        A client sends one request per line and gets one response line back
+ *        for each, in order; it may pipeline several requests and keep the
+ *        connection open. The accepting thread polls every open connection
+ *        and queues each complete request line as its own job for a fixed set
+ *        of worker threads, which share the handler (and the data behind it)
+ *        read-only. Client sockets are non-blocking: responses the client has
+ *        not read yet wait in the connection's buffer and the poll loop
+ *        sends them when the socket is writable. Neither idle clients nor
+ *        clients that stop reading hold a worker, so any number of clients
+ *        are served by a few threads. A connection has at most one job in
+ *        flight, which keeps its responses in request order. SIGINT and
+ *        SIGTERM stop the server and remove the socket.
+ */
+class QueryServer {
+public:
+    // Response for one request line, without the trailing newline; must be thread-safe
+    using Handler = std::function<std::string(const std::string& request)>;
+
+    // Serve on socketPath with `threads` workers (0 = 8)
+    QueryServer(const std::string& socketPath, unsigned threads, Handler handler);
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    // Create the socket (replacing a stale one) and listen; false with a message on stderr
+    bool start();
+    // Accept and serve clients until stop(), SIGINT or SIGTERM; then close every connection
+    void run();
+    // Ask run() to return; callable from any thread
+    void stop();
+
+    unsigned threadCount() const { return threads; }
+    uint64_t requests() const { return requestCount.load(); }
+
+    static const size_t MAX_LINE_BYTES = 64 * 1024;
+    // Request lines a connection may have waiting before the server stops reading from it
+    static const size_t MAX_QUEUED_LINES = 64;
+    // Unsent response bytes a connection may hold before its next line waits for the client to read
+    static const size_t MAX_UNSENT_BYTES = 4 * 1024 * 1024;
+
+private:
+    /**
+     * @brief State of one client connection, keyed by its socket in `connections`
+     */
+    struct Connection {
+        std::string input;              // Received bytes after the last complete line
+        std::deque<std::string> lines;  // Complete requests not yet answered
+        std::string output;             // Responses the socket has not taken yet
+        bool busy = false;              // A worker is answering (or has queued) this connection
+        bool closing = false;           // Read side ended; close once everything is answered and sent
+        bool broken = false;            // A send failed; close as soon as no worker holds it
+    };
+
+    // Worker: answer one line per job until the server stops
+    void work();
+    // Read what `client` has sent and queue its complete lines (poll loop only)
+    void readClient(int client);
+    // Send pending output once `client` is writable again (poll loop only)
+    void writeClient(int client);
+    // Send what the non-blocking socket takes of connection.output; lock held
+    void flush(int client, Connection& connection);
+    // Queue the connection for a worker if it has a line to answer and room for the answer; lock held
+    bool schedule(int client, Connection& connection);
+    // True once the connection can be closed
+    static bool finished(const Connection& connection);
+    // Close every closing connection no worker holds (poll loop only)
+    void reapClosed();
+    // Wake the poll loop, e.g. when a connection can be closed
+    void wake();
+    bool stopping() const;
+
+    std::string socketPath;
+    unsigned threads;
+    Handler handler;
+    int listener;
+    std::atomic<bool> stopRequested;
+    std::atomic<uint64_t> requestCount;
+
+    int wakeRead;
+    int wakeWrite;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::unordered_map<int, Connection> connections;
+    std::deque<int> pending; // Connections with a line to answer, each queued at most once
+    std::vector<std::thread> workers;
+};
+
+#endif // QUERYSERVER_H
@@ -0,0 +1,89 @@
+#ifndef RANGEINDEX_H
+#define RANGEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "WeatherTable.h"
+
+/**
+ * @brief Range-query index over one numeric column (NaN = missing)
+ *        - Prefix sums and prefix counts of the non-missing values give the
+ *          sum, count and mean of any row range in O(1), and its first and last
+ *          reading by binary search in O(log n)
+ *        - Per-block min/max plus a sparse table over the blocks give the
+ *          min/max of the whole blocks in O(1); at most two partial blocks
+ *          are scanned at the edges
+ */
+class RangeIndex {
+public:
+    /**
+     * @brief Summary of the non-missing values in a row range
+     */
+    struct Stats {
+        size_t count; // Non-missing values in the range
+        double open;  // First value
+        double high;
+        double low;
+        double close; // Last value
+        double mean;
+
+        Stats();
+    };
+
+    RangeIndex();
+
+    // Index `count` values; the array must outlive the index
+    void build(const double* values, size_t count);
+
+    size_t size() const { return rows; }
+
+    // Stats of rows [begin, end); count == 0 if the range holds no value
+    Stats query(size_t begin, size_t end) const;
+
+private:
+    static const size_t BLOCK_SIZE = 64;
+
+    const double* values;
+    size_t rows;
+    std::vector<double> prefixSum;     // rows + 1 entries
+    std::vector<uint32_t> prefixCount; // rows + 1 entries
+    // minTable[l][b] = min of blocks [b, b + 2^l); level 0 is the per-block min
+    std::vector<std::vector<double>> minTable;
+    std::vector<std::vector<double>> maxTable;
+};
+
+/**
+ * @brief Time-window queries over a WeatherTable: binary search on the
+ *        timestamp column finds the rows, and a RangeIndex per column
+ *        (built on first use, thread-safe) answers the window.
+ *        Timestamps are expected in ascending order; if they are not, queries
+ *        fall back to scanning the rows.
+ */
+class WindowIndex {
+public:
+    WindowIndex();
+
+    // Index a table; the table must outlive the index or be re-attached after a reload
+    void attach(const WeatherTable& table);
+    void clear();
+
+    // Rows whose timestamps fall in [from, to) epoch seconds (ascending tables only)
+    std::pair<size_t, size_t> rowRange(int64_t from, int64_t to) const;
+
+    // Stats of a column over [from, to); count == 0 if the window holds no value
+    RangeIndex::Stats query(size_t column, int64_t from, int64_t to) const;
+
+private:
+    const RangeIndex& columnIndex(size_t column) const;
+
+    const WeatherTable* table;
+    bool sorted;
+    mutable std::mutex mutex; // Guards first-time builds
+    mutable std::vector<std::unique_ptr<RangeIndex>> columns;
+};
+
+#endif // RANGEINDEX_H
@@ -0,0 +1,51 @@
+#ifndef REDUCEKERNELS_H
+#define REDUCEKERNELS_H
+
+#include <cstddef>
+
+/**
+ * @brief Vectorised reductions over contiguous runs of doubles.
+ *        NaN means "missing" and is skipped. The AVX2 kernel handles 4 values
+ *        per step: an ordered-compare mask drops the NaNs from the sum, the
+ *        count (popcount of the mask) and the min/max. The implementation is
+ *        chosen once at runtime; a scalar loop is the fallback.
+ *        dot() is the building block of the normal-equation accumulators; it
+ *        expects dense inputs (no NaN).
+ */
+class ReduceKernels {
+public:
+    enum class Implementation { Scalar, AVX2 };
+
+    /**
+     * @brief Sum, count, min and max of the non-missing values seen so far
+     */
+    struct Summary {
+        double sum;
+        size_t count;
+        double min;
+        double max;
+
+        Summary();
+    };
+
+    // Best implementation supported by the running CPU
+    static Implementation bestImplementation();
+    static const char* implementationName(Implementation impl);
+
+    // Fold values[0, length) into summary. The vector kernel adds in a different
+    // order than the scalar loop, so sums may differ in the last bits.
+    static void reduce(const double* values, size_t length, Summary& summary);
+
+    // Same as above with an explicit implementation (used by the benchmark)
+    static void reduce(Implementation impl, const double* values, size_t length, Summary& summary);
+
+    // Sum of a[i] * b[i] over [0, length); inputs must not contain NaN
+    static double dot(const double* a, const double* b, size_t length);
+    static double dot(Implementation impl, const double* a, const double* b, size_t length);
+
+    // Index of the first / last non-missing value in values[0, length), or length if none
+    static size_t firstPresent(const double* values, size_t length);
+    static size_t lastPresent(const double* values, size_t length);
+};
+
+#endif // REDUCEKERNELS_H
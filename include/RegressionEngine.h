@@ -0,0 +1,96 @@
+#ifndef REGRESSIONENGINE_H
+#define REGRESSIONENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "WeatherRollup.h"
+
+/**
+ * @brief Least-squares trend lines (y = slope * period + intercept) for many
+ *        series at once, fed from the mean of each rollup bucket.
+ *        Every series keeps mergeable sufficient statistics: the point count,
+ *        the means and the centred co-moments. Centring keeps large x values
+ *        (years, day numbers) from cancelling out the way raw sums of x^2 do.
+ *        All series are fitted in one pass over the periods; blocks of periods
+ *        run on separate threads and their statistics are merged. A changed or
+ *        new period is folded in with one O(1) remove/add each, so refreshing
+ *        after new data does not refit the history.
+ */
+class RegressionEngine {
+public:
+    /**
+     * @brief Sufficient statistics of a set of (x, y) points
+     */
+    struct Moments {
+        double n;
+        double meanX;
+        double meanY;
+        double cxx; // Sum of (x - meanX)^2
+        double cxy; // Sum of (x - meanX) * (y - meanY)
+
+        Moments();
+
+        // Add or take back one point (Welford update and its inverse)
+        void add(double x, double y);
+        void remove(double x, double y);
+        // Combine with the statistics of another, disjoint set of points
+        void merge(const Moments& other);
+
+        // Least-squares line; false with fewer than two distinct x values
+        bool fit(double& slope, double& intercept) const;
+    };
+
+    /**
+     * @brief Fitted line of one series
+     */
+    struct Fit {
+        bool valid;
+        double slope;       // Change per period
+        double intercept;
+        size_t points;      // Periods with data
+        int64_t lastPeriod; // Last period with data
+
+        Fit();
+
+        double predict(int64_t period) const { return slope * static_cast<double>(period) + intercept; }
+    };
+
+    RegressionEngine();
+
+    // Fit every listed table column of the rollup at one granularity, on `workers` threads
+    // (0 = one per core). Columns missing from the rollup get no series.
+    void build(const WeatherRollup& rollup, const std::vector<size_t>& columns, WeatherRollup::Granularity granularity,
+               unsigned workers = 0);
+
+    // Re-read periods fromPeriod onwards after the rollup absorbed new rows: each changed
+    // period costs one remove and one add. Falls back to build() if the level moved.
+    void update(const WeatherRollup& rollup, int64_t fromPeriod);
+
+    void clear();
+    bool empty() const { return series.empty(); }
+    WeatherRollup::Granularity granularity() const { return level; }
+
+    // Fit of a table column; invalid if the column has no series or too few points
+    Fit fit(size_t column) const;
+
+private:
+    /**
+     * @brief One fitted column and the y it currently holds for each period (NaN = none)
+     */
+    struct Series {
+        size_t column;
+        Moments moments;
+        std::vector<double> values;
+    };
+
+    // Index of the series of a table column, or -1
+    int seriesIndex(size_t column) const;
+
+    WeatherRollup::Granularity level;
+    int64_t firstPeriod;
+    std::vector<Series> series;
+    unsigned workers;
+};
+
+#endif // REGRESSIONENGINE_H
@@ -0,0 +1,59 @@
+#ifndef SEASONALMODEL_H
+#define SEASONALMODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "WeatherRollup.h"
+
+/**
+ * @brief Least-squares fit of an hourly series to a linear trend plus annual
+ *        and diurnal Fourier harmonics:
+ *          y(t) = b0 + b1 * years(t)
+ *                 + sum_k (a_k cos(k * yearAngle) + c_k sin(k * yearAngle))
+ *                 + sum_k (d_k cos(k * dayAngle) + e_k sin(k * dayAngle))
+ *        Every reading is used. Rows are packed into blocks of feature vectors,
+ *        and X^T X and X^T y are accumulated block by block with the vector
+ *        dot kernels. Row ranges run on separate threads and their sums are
+ *        added. The small normal-equation system is then solved by Cholesky.
+ */
+class SeasonalModel {
+public:
+    explicit SeasonalModel(int annualHarmonics = 3, int diurnalHarmonics = 2);
+
+    // Fit to values[0, rows) at the given epoch timestamps on `workers` threads
+    // (0 = one per core). Missing (NaN) values are skipped. Returns false if there are
+    // too few readings or the system is singular.
+    bool fit(const int64_t* timestamps, const double* values, size_t rows, unsigned workers = 0);
+
+    bool fitted() const { return !coefficients.empty(); }
+
+    // Modelled value at an instant
+    double predict(int64_t epochSeconds) const;
+    // Mean of the model over a period, sampled hourly
+    double periodMean(WeatherRollup::Granularity granularity, int64_t period) const;
+
+    size_t featureCount() const { return static_cast<size_t>(2 + 2 * annual + 2 * diurnal); }
+    size_t points() const { return pointCount; }
+    double rmse() const { return rootMeanSquare; }
+    double rSquared() const { return determination; }
+
+    // Trend slope per year, and the amplitude of the first annual and diurnal harmonic
+    double trendPerYear() const;
+    double annualAmplitude() const;
+    double diurnalAmplitude() const;
+
+private:
+    // Feature vector of one instant into out[0, featureCount())
+    void features(int64_t epochSeconds, double* out) const;
+
+    int annual;
+    int diurnal;
+    int64_t origin; // Trend term is measured in years from here (mid-point of the data)
+    std::vector<double> coefficients;
+    size_t pointCount;
+    double rootMeanSquare;
+    double determination;
+};
+
+#endif // SEASONALMODEL_H
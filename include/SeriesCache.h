@@ -0,0 +1,98 @@
+#ifndef SERIESCACHE_H
+#define SERIESCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Candlestick.h"
+#include "RangeIndex.h"
+#include "WeatherRollup.h"
+
+/**
+ * @brief Bounded LRU cache of computed series, keyed by the query that
+ *        produced them. Entries are charged by their approximate heap size,
+ *        and the least recently used ones are evicted once the byte budget is
+ *        exceeded. Results are shared immutably, so a hit costs a lookup and a
+ *        reference count. All methods are thread-safe.
+ */
+class SeriesCache {
+public:
+    // What was asked for: one key per distinct analysis query
+    struct Key {
+        std::string country;
+        std::string metric;
+        WeatherRollup::Granularity granularity;
+        int64_t from;          // Time range [from, to) in epoch seconds; the full range for whole series
+        int64_t to;
+        std::string aggregate; // e.g. "ohlc", "mean", "max", "min", "p90", "window"
+
+        Key(const std::string& country_, const std::string& metric_, WeatherRollup::Granularity granularity_,
+            const std::string& aggregate_, int64_t from_ = FULL_RANGE_FROM, int64_t to_ = FULL_RANGE_TO);
+
+        bool operator==(const Key& other) const;
+    };
+
+    // A cached result: candlesticks, (period, value) points or one window summary
+    struct Series {
+        std::vector<Candlestick> candles;
+        std::vector<std::pair<int, double>> points;
+        RangeIndex::Stats window;
+    };
+
+    static const int64_t FULL_RANGE_FROM;
+    static const int64_t FULL_RANGE_TO;
+
+    explicit SeriesCache(size_t capacityBytes = 64 * 1024 * 1024);
+
+    // Cached series for `key` (marked most recently used), or nullptr on a miss
+    std::shared_ptr<const Series> find(const Key& key);
+
+    // Insert or replace the series for `key`, evicting old entries to stay within budget.
+    // A series larger than the whole budget is returned but not kept.
+    std::shared_ptr<const Series> store(const Key& key, Series series);
+
+    // Drop every entry (e.g. after the data changed); counters are kept
+    void clear();
+
+    size_t bytes() const;
+    size_t entries() const;
+    size_t capacity() const { return capacityBytes; }
+    uint64_t hits() const;
+    uint64_t misses() const;
+    uint64_t evictions() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const Series> series;
+        size_t bytes;
+    };
+
+    // Approximate heap footprint of an entry
+    static size_t entryBytes(const Key& key, const Series& series);
+
+    // Evict from the cold end until usedBytes <= capacityBytes (mutex held)
+    void evictToCapacity();
+
+    size_t capacityBytes;
+    size_t usedBytes;
+    uint64_t hitCount;
+    uint64_t missCount;
+    uint64_t evictionCount;
+
+    std::list<Entry> recency; // Front = most recently used
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup;
+    mutable std::mutex mutex;
+};
+
+#endif // SERIESCACHE_H
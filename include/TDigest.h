@@ -0,0 +1,59 @@
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Mergeable quantile sketch (merging t-digest, T. Dunning)
+ *        Values are summarised by weighted centroids. The k1 scale function
+ *        keeps centroids small near the tails, so extreme percentiles stay
+ *        accurate, and caps their number at about `compression`. Memory is
+ *        bounded no matter how many values are added. Two digests merge into
+ *        one that summarises both inputs, so per-thread or per-period sketches
+ *        can be combined. Small inputs keep every value, so their quantiles
+ *        are exact.
+ */
+class TDigest {
+public:
+    explicit TDigest(double compression = 100.0);
+
+    // Add one value; NaN is ignored
+    void add(double value);
+    // Add a run of values; NaN (missing) is ignored
+    void add(const double* values, size_t length);
+
+    // Fold another digest into this one
+    void merge(const TDigest& other);
+
+    // Estimated q-quantile (q in [0, 1]); NaN if the digest is empty
+    double quantile(double q) const;
+
+    double count() const { return totalWeight + buffer.size(); }
+    bool empty() const { return count() == 0.0; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+
+    // Centroids currently kept (after folding in the buffered values)
+    size_t centroidCount() const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    // Merge the buffered values into the centroid list
+    void flush();
+    // Sort the buffer, the current centroids and `incoming` together and re-cluster them
+    void compress(std::vector<Centroid>& incoming);
+
+    double compression;
+    std::vector<Centroid> centroids; // Sorted by mean
+    std::vector<double> buffer;      // Values not yet merged
+    double totalWeight;              // Weight of the centroids
+    double minValue;
+    double maxValue;
+};
+
+#endif // TDIGEST_H
@@ -0,0 +1,63 @@
+#ifndef TEXTFRAME_H
+#define TEXTFRAME_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fixed grid of character cells that a text chart is drawn into
+ *        before anything is printed.
+ *        Rendering walks the grid once into a preallocated buffer: a color
+ *        escape is emitted only where the color actually changes (blank cells
+ *        never change it, so neighbouring bars share one run), trailing blanks
+ *        are dropped, and the finished frame goes out in a single write().
+ *        Colors are left out when NO_COLOR is set or stdout is not a terminal.
+ */
+class TextFrame {
+public:
+    enum class Color {
+        Default,
+        Red,
+        Green,
+        Blue
+    };
+
+    // Blank frame of width x height cells
+    TextFrame(size_t width, size_t height);
+
+    size_t width() const { return columns; }
+    size_t height() const { return rows; }
+
+    // Put one UTF-8 character in a cell; cells outside the frame are ignored
+    void put(size_t row, size_t column, const char* glyph, Color color = Color::Default);
+    // Put text from a cell onwards, one cell per UTF-8 character; returns the column after it
+    size_t text(size_t row, size_t column, const std::string& value, Color color = Color::Default);
+
+    // Compose the frame, with or without color escapes
+    const std::string& render(bool color);
+    // Flush std::cout (to keep earlier output in order), then write the frame to stdout at once
+    void print();
+
+    // False when NO_COLOR is set (to anything) or stdout is not a terminal
+    static bool colorEnabled();
+    // Columns of the terminal on stdout, else $COLUMNS, else `fallback` (0 = no limit)
+    static size_t terminalWidth(size_t fallback = 0);
+
+private:
+    /**
+     * @brief One character cell: up to four UTF-8 bytes and a color
+     */
+    struct Cell {
+        char bytes[4];
+        unsigned char size;
+        Color color;
+    };
+
+    size_t columns;
+    size_t rows;
+    std::vector<Cell> cells; // Row-major
+    std::string output;      // Reused by every render
+};
+
+#endif // TEXTFRAME_H
@@ -0,0 +1,83 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads draining a shared task queue.
+ *        Unlike Parallel::run, which forks one task per worker and joins,
+ *        the pool takes any number of small independent tasks (e.g. every
+ *        model candidate of every country) and balances them across the
+ *        workers. Tasks are submitted into a Batch, and wait() returns once
+ *        that batch has finished, however busy the pool is with other
+ *        callers' batches. The waiting thread runs its own batch's queued
+ *        tasks as well, so a pool of one worker still makes progress on a
+ *        single core. Tasks must not call wait() themselves.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Completion counter for one caller's tasks; lives on the caller's stack.
+     *        If the caller unwinds before wait(), the destructor waits for the tasks
+     *        that still point at it
+     */
+    class Batch {
+    public:
+        Batch() : pool(nullptr), pending(0) {}
+        ~Batch();
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+    private:
+        friend class ThreadPool;
+        ThreadPool* pool;          // Set by the first submit
+        size_t pending;            // Tasks submitted but not finished; guarded by the pool's mutex
+        std::exception_ptr error;  // First exception a task of this batch threw
+    };
+
+    // Start `workers` threads (0 = one per hardware thread)
+    explicit ThreadPool(unsigned workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task of `batch`; it runs on some worker (or in wait(batch))
+    void submit(Batch& batch, std::function<void()> task);
+
+    // Block until every task of `batch` has finished, running its queued tasks meanwhile;
+    // then rethrow the first exception one of them threw
+    void wait(Batch& batch);
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+private:
+    /**
+     * @brief Queued task and the batch it counts against
+     */
+    struct Task {
+        std::function<void()> run;
+        Batch* batch;
+    };
+
+    void workerLoop();
+    // Run `task` with the lock held on entry (and on return), then count it off its batch;
+    // an exception is stored in the batch, never propagated
+    void runTask(Task task, std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> threads;
+    std::deque<Task> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable batchDone;
+    bool stopping;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,40 @@
+#ifndef TIMEUTILS_H
+#define TIMEUTILS_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Conversions between ISO-8601 UTC timestamps and epoch seconds
+ */
+class TimeUtils {
+public:
+    // Parse "YYYY-MM-DDTHH:MM:SSZ" (time part optional) into seconds since 1970-01-01 UTC
+    static bool parseTimestamp(std::string_view text, int64_t& epochSeconds);
+
+    // Strict parse of user input: exactly "YYYY-MM-DD" or "YYYY-MM-DD[T ]HH:MM:SS", with the
+    // day checked against its month and the time against 23:59:59; nothing may follow
+    static bool parseDateTime(std::string_view text, int64_t& epochSeconds);
+
+    // Seconds since epoch for a civil UTC date and time
+    static int64_t toEpoch(int year, int month, int day, int hour = 0, int minute = 0, int second = 0);
+
+    // Civil UTC date of an epoch timestamp
+    static void toCivil(int64_t epochSeconds, int& year, int& month, int& day);
+
+    // Calendar year of an epoch timestamp
+    static int yearOf(int64_t epochSeconds);
+
+    // Write "YYYY-MM-DDTHH:MM:SSZ" (TIMESTAMP_LENGTH chars, years 0..9999) to out; no allocation
+    static void formatTimestamp(int64_t epochSeconds, char* out);
+    static const int TIMESTAMP_LENGTH = 20;
+
+    // Whole days since 1970-01-01 (floored, so pre-1970 times map to negative days)
+    static int64_t dayNumber(int64_t epochSeconds);
+
+private:
+    static int64_t daysFromCivil(int year, int month, int day);
+    static void civilFromDays(int64_t days, int& year, int& month, int& day);
+};
+
+#endif // TIMEUTILS_H
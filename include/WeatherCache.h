@@ -0,0 +1,39 @@
+#ifndef WEATHERCACHE_H
+#define WEATHERCACHE_H
+
+#include <string>
+#include "WeatherTable.h"
+
+/**
+ * @brief Compact binary on-disk copy of a WeatherTable.
+ *
+ * Layout (native byte order, every array 64-byte aligned):
+ *   header   magic "WXCACHE1", version, column/row counts, section offsets,
+ *            size of the source CSV
+ *   names    per column: uint32 length + bytes
+ *   stats    per column: uint64 missing + uint64 invalid cell counts
+ *   int64    epoch timestamps [rows]
+ *   double   one array per numeric column [rows]
+ *
+ * Loading maps the file and points the table straight at the arrays,
+ * so a warm start does no parsing and no copying.
+ */
+class WeatherCache {
+public:
+    // Cache file used for a given CSV file ("<csv>.cache")
+    static std::string cachePathFor(const std::string& csvFilename);
+
+    // True if the cache exists and was written after the CSV was last modified
+    static bool isFresh(const std::string& cacheFilename, const std::string& csvFilename);
+
+    // Serialise a table. Written to a temporary file and renamed into place.
+    static bool write(const WeatherTable& table, const std::string& cacheFilename, const std::string& csvFilename);
+
+    // Map a cache file into a table. Returns false if the file is missing or malformed.
+    static bool read(const std::string& cacheFilename, WeatherTable& table);
+
+    // Load through a fresh cache, or parse the CSV and rebuild a stale or missing cache
+    static bool loadOrBuild(const std::string& csvFilename, WeatherTable& table, unsigned workers = 0);
+};
+
+#endif // WEATHERCACHE_H
@@ -0,0 +1,162 @@
+#ifndef WEATHERROLLUP_H
+#define WEATHERROLLUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TDigest.h"
+#include "WeatherTable.h"
+
+/**
+ * @brief Pre-aggregated rollup pyramid over columns of a WeatherTable
+ *        - Day buckets are reduced from the raw rows in one pass, one SIMD
+ *          kernel call per day
+ *        - Week and month buckets are merged from the day level
+ *        - Year buckets are merged from the month level
+ *        Each bucket keeps sum, count, min, max, first and last of the
+ *        non-missing values, so candlestick, histogram and regression queries
+ *        at any granularity read a few hundred buckets instead of the rows.
+ *        Percentiles cannot be merged from these buckets; sketches() streams
+ *        the rows of one column into a bounded-size t-digest per period.
+ *        Every level is dense: bucket i covers period firstPeriod(g) + i, and
+ *        periods without data have count == 0. "first" and "last" follow row
+ *        order, which is chronological for the weather CSV.
+ *        Rows appended to the table in time order are folded in by append(),
+ *        which touches only the new days and the weeks, months and years
+ *        that contain them.
+ */
+class WeatherRollup {
+public:
+    enum class Granularity {
+        Day,
+        Week,  // Monday to Sunday
+        Month,
+        Year
+    };
+
+    /**
+     * @brief Aggregate of one column over one period
+     */
+    struct Bucket {
+        double sum;
+        double min;
+        double max;
+        double first;
+        double last;
+        size_t count;
+
+        Bucket();
+
+        double mean() const { return sum / count; }
+
+        // Fold in the next value in time order
+        void add(double value);
+        // Fold in the next run of consecutive values (NaN = missing) with the SIMD kernels
+        void addRun(const double* values, size_t length);
+        // Fold in the aggregate of the following stretch of time
+        void merge(const Bucket& later);
+    };
+
+    /**
+     * @brief Rows [begin, end) that fall in one period
+     */
+    struct Run {
+        size_t begin;
+        size_t end;
+        int64_t period;
+    };
+
+    WeatherRollup();
+
+    // Build every level for the given table columns on `workers` threads (0 = one per core).
+    // Returns false if the table is empty.
+    bool build(const WeatherTable& table, const std::vector<size_t>& columnIndices, unsigned workers = 0);
+
+    // Fold rows [firstRow, rowCount()) of the same table, appended since the last build or
+    // append, into the levels. New days extend each level; only the buckets of the periods
+    // holding new rows are recomputed. Tables that are no longer in time order are rebuilt.
+    bool append(const WeatherTable& table, size_t firstRow, unsigned workers = 0);
+
+    void clear();
+    bool empty() const { return columnSlots.empty(); }
+
+    // True if `column` (a table column index) was part of the last build
+    bool hasColumn(size_t column) const;
+
+    // Number of periods at a level (including empty ones) and the key of the first
+    size_t bucketCount(Granularity granularity) const { return levels[level(granularity)].count; }
+    int64_t firstPeriod(Granularity granularity) const { return levels[level(granularity)].firstPeriod; }
+
+    // bucketCount(granularity) buckets for a table column, or nullptr if it was not built
+    const Bucket* buckets(Granularity granularity, size_t column) const;
+
+    // One quantile sketch per period of a table column, aligned with buckets(): entry i
+    // covers period firstPeriod(granularity) + i. Streamed from the rows on demand, one
+    // digest per period and worker, merged at the end. Empty if the rollup was not built.
+    std::vector<TDigest> sketches(const WeatherTable& table, size_t column, Granularity granularity,
+                                  unsigned workers = 0) const;
+
+    // Period keys: days or weeks since 1970, year * 12 + month - 1, or the year
+    static int64_t periodOf(Granularity granularity, int64_t epochSeconds);
+    static int64_t periodStart(Granularity granularity, int64_t period);
+    // "YYYY", "YYYY-MM" or "YYYY-MM-DD" (the Monday of a week)
+    static std::string periodLabel(Granularity granularity, int64_t period);
+    // Axis tick without string work: the year, the month (1-12) or the day of the month
+    // (of the Monday for weeks)
+    static int periodTick(Granularity granularity, int64_t period);
+
+    // Split rows [begin, end) into same-period runs. With ascending timestamps each run
+    // ends at the period boundary, found by galloping binary search; otherwise every
+    // row is compared against the current period.
+    static std::vector<Run> periodRuns(const int64_t* timestamps, size_t begin, size_t end,
+                                       Granularity granularity, bool ascending);
+
+    // "day", "week", "month", "year" and their adjectives ("Daily", ...)
+    static const char* granularityName(Granularity granularity);
+    static const char* granularityAdjective(Granularity granularity);
+    // Accepts a name, an adjective or a first letter, case-insensitively
+    static bool parseGranularity(const std::string& text, Granularity& granularity);
+
+private:
+    static const size_t LEVEL_COUNT = 4;
+
+    /**
+     * @brief One level of the pyramid; columns[slot][i] is period firstPeriod + i
+     */
+    struct Level {
+        int64_t firstPeriod = 0;
+        size_t count = 0;
+        std::vector<std::vector<Bucket>> columns;
+    };
+
+    /**
+     * @brief Where re-deriving the coarser levels starts, and the parent bucket of each
+     *        day and month from there on
+     */
+    struct Parents {
+        size_t weekFromDay;              // First day of the first week to recompute
+        size_t monthFromDay;             // First day of the first month to recompute
+        size_t yearFromMonth;            // January of the first year to recompute
+        std::vector<size_t> weekOfDay;   // Indexed from min(weekFromDay, monthFromDay)
+        std::vector<size_t> monthOfDay;
+        std::vector<size_t> yearOfMonth; // Indexed from yearFromMonth
+    };
+
+    static size_t level(Granularity granularity) { return static_cast<size_t>(granularity); }
+
+    // Grow every level to cover day key `lastDay`
+    void extendLevels(int64_t lastDay);
+    // Parent maps for re-deriving every period that contains day index `firstDay` or a later day
+    Parents parentsFrom(size_t firstDay) const;
+    // Recompute the week, month and year buckets of one column slot from its day buckets
+    void rollUp(size_t slot, const Parents& parents);
+    // Table column of each slot
+    std::vector<size_t> builtColumns() const;
+
+    Level levels[LEVEL_COUNT];
+    // Table column index -> slot in Level::columns, or -1
+    std::vector<int> columnSlots;
+};
+
+#endif // WEATHERROLLUP_H
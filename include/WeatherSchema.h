@@ -0,0 +1,48 @@
+#ifndef WEATHERSCHEMA_H
+#define WEATHERSCHEMA_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Column layout of the weather data, built once per load.
+ *        Header names have the form "<country>_<metric>", e.g. "DE_temperature"
+ *        or "DE_radiation_direct_horizontal". (country, metric) pairs map to a
+ *        column index through two hash lookups and a dense grid, so no lookup
+ *        builds strings or scans the header.
+ */
+class WeatherSchema {
+public:
+    // Metric name of the temperature columns
+    static const std::string TEMPERATURE;
+
+    WeatherSchema();
+
+    // Rebuild from the numeric column names (column index = position in the list)
+    void build(const std::vector<std::string>& columnNames);
+
+    // Column index for a country and metric, or -1 if absent
+    int columnIndex(const std::string& country, const std::string& metric) const;
+
+    // Column index for a full header name, or -1 if absent
+    int findColumn(const std::string& name) const;
+
+    // Countries and metrics in header order
+    const std::vector<std::string>& countries() const { return countryNames; }
+    const std::vector<std::string>& metrics() const { return metricNames; }
+
+    bool hasCountry(const std::string& country) const { return countryIds.count(country) > 0; }
+
+private:
+    std::unordered_map<std::string, int> columnIds;
+    std::unordered_map<std::string, int> countryIds;
+    std::unordered_map<std::string, int> metricIds;
+    std::vector<std::string> countryNames;
+    std::vector<std::string> metricNames;
+
+    // grid[country * metricNames.size() + metric] = column index or -1
+    std::vector<int> grid;
+};
+
+#endif // WEATHERSCHEMA_H
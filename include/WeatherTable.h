@@ -0,0 +1,141 @@
+#ifndef WEATHERTABLE_H
+#define WEATHERTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MappedCSV.h"
+#include "MappedFile.h"
+#include "WeatherSchema.h"
+
+/**
+ * @brief Typed, column-oriented copy of the weather CSV
+ *        - One int64 epoch timestamp column (seconds, UTC)
+ *        - One contiguous double array per numeric column
+ *          (XX_temperature, XX_radiation_...); empty or invalid cells are NaN
+ *        The CSV text is parsed exactly once, in load(). The arrays either own
+ *        their storage or view a memory-mapped binary cache (see WeatherCache).
+ *        In projected mode (loadProjected) only the requested columns are parsed
+ *        up front; any other column is parsed from the mapped CSV the first time
+ *        it is read and kept from then on. Reading columns is thread-safe.
+ *        Rows appended to the CSV later are picked up by appendNewRows(), which
+ *        parses only the bytes after the last consumed offset.
+ */
+class WeatherTable {
+public:
+    /**
+     * @brief Cells of one column that did not hold a number
+     */
+    struct ColumnStats {
+        size_t missing; // Empty cells and cells absent from short rows
+        size_t invalid; // Cells that are not a number
+
+        ColumnStats() : missing(0), invalid(0) {}
+    };
+
+    WeatherTable();
+
+    WeatherTable(WeatherTable&&) = default;
+    WeatherTable& operator=(WeatherTable&&) = default;
+    WeatherTable(const WeatherTable&) = delete;
+    WeatherTable& operator=(const WeatherTable&) = delete;
+
+    // Read and parse a CSV file on `workers` threads (0 = one per core).
+    // Returns false if nothing could be loaded.
+    bool load(const std::string& filename, unsigned workers = 0);
+
+    // Parse an already mapped CSV file; the result does not depend on the worker count
+    bool loadFromCSV(const MappedCSV& csv, unsigned workers = 0);
+
+    // Parse the timestamps and only the named columns, skipping other fields by
+    // scanning for delimiters. Unknown names are ignored.
+    bool loadProjected(const std::string& filename, const std::vector<std::string>& projection, unsigned workers = 0);
+
+    // Parse the complete lines appended to `filename` since the last load or append and
+    // add them as rows; a trailing partial line is left for the next call. Mapped or
+    // lazily parsed storage is first copied into owned vectors. `firstNewRow` receives
+    // the index of the first added row (rowCount() if there was none). Returns false if
+    // the file cannot be read or is shorter than what was consumed (it was replaced).
+    // Invalidates the arrays returned by timestamps() and column(); not thread-safe.
+    bool appendNewRows(const std::string& filename, size_t& firstNewRow, unsigned workers = 0);
+
+    // Bytes of the source CSV consumed so far; the next append starts here
+    uint64_t consumedBytes() const { return sourceBytes; }
+
+    // True once a column's values are in memory
+    bool isColumnLoaded(size_t index) const { return columnData[index].load(std::memory_order_acquire) != nullptr; }
+
+    bool empty() const { return rows == 0; }
+    size_t rowCount() const { return rows; }
+
+    // Numeric columns only; the timestamp column is not counted
+    size_t columnCount() const { return columnNames.size(); }
+    const std::string& columnName(size_t index) const { return columnNames[index]; }
+
+    // Index of a numeric column by header name, or -1 if absent
+    int findColumn(const std::string& name) const { return tableSchema.findColumn(name); }
+
+    // (country, metric) -> column lookup, built once per load
+    const WeatherSchema& schema() const { return tableSchema; }
+
+    // Per-column counts of cells stored as NaN (loads the column if needed)
+    const ColumnStats& columnStats(size_t index) const;
+
+    // Data rows dropped because their timestamp could not be parsed
+    size_t skippedRowCount() const { return skippedRows; }
+
+    // True if timestamps() never decreases, so periods and windows are contiguous row ranges
+    bool timestampsAscending() const { return ascending; }
+
+    // Contiguous arrays of rowCount() values
+    const int64_t* timestamps() const { return timestampData; }
+    const double* column(size_t index) const
+    {
+        const double* values = columnData[index].load(std::memory_order_acquire);
+        return values != nullptr ? values : loadColumn(index);
+    }
+
+private:
+    friend class WeatherCache;
+
+    // Mapped CSV and row offsets kept in projected mode
+    struct LazySource;
+
+    void clear();
+    // Replace the column views with `count` unloaded entries
+    void resetColumnViews(size_t count);
+    // Point the read views at the owned vectors
+    void useOwnedStorage();
+    // Record whether the timestamp view is in ascending order
+    void checkTimestampOrder();
+    // Copy mapped or lazily parsed columns into the owned vectors, so rows can be appended
+    void materialise();
+    // Parse one column from the lazy source on first access
+    const double* loadColumn(size_t index) const;
+
+    std::vector<std::string> columnNames;
+    WeatherSchema tableSchema;
+    size_t rows;
+    mutable std::vector<ColumnStats> stats; // Filled on first access in projected mode
+    size_t skippedRows;
+    uint64_t sourceBytes; // Size of the CSV text parsed so far
+
+    // Owned storage (filled when parsing CSV text; in projected mode on first access)
+    std::vector<int64_t> timestampColumn;
+    mutable std::vector<std::vector<double>> columns;
+
+    std::shared_ptr<LazySource> lazySource;
+
+    // Mapped binary cache backing the views instead of the vectors
+    std::shared_ptr<MappedFile> mappedCache;
+
+    // Views read by every analysis; a null column view means "not parsed yet"
+    const int64_t* timestampData;
+    bool ascending;
+    mutable std::vector<std::atomic<const double*>> columnData;
+};
+
+#endif // WEATHERTABLE_H
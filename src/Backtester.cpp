@@ -0,0 +1,184 @@
+#include "Backtester.h"
+#include <algorithm>
+#include <cmath>
+#include "RegressionEngine.h"
+
+namespace {
+    const size_t MIN_TRAINING = 3;
+
+    /**
+     * @brief One training prefix: series index and the number of periods before the cutoff
+     */
+    struct Fold {
+        size_t series;
+        size_t length;
+    };
+
+    size_t modelIndex(Backtester::Model model)
+    {
+        return static_cast<size_t>(model);
+    }
+
+    /**
+     * @brief Score the cheap baselines of every fold of one series. The linear fit of each
+     *        prefix comes from one cumulative pass of regression moments.
+     */
+    void scoreBaselines(const std::vector<double>& values, const std::vector<Fold>& folds, const std::vector<char>& usable,
+                        size_t first, size_t last, int horizon, int seasonLength, std::vector<Backtester::Score>& scores)
+    {
+        // prefix[k] = moments of the points t < k, with x = t
+        std::vector<RegressionEngine::Moments> prefix(values.size() + 1);
+        for (size_t t = 0; t < values.size(); ++t) {
+            prefix[t + 1] = prefix[t];
+            prefix[t + 1].add(static_cast<double>(t), values[t]);
+        }
+
+        size_t season = static_cast<size_t>(std::max(seasonLength, 1));
+        for (size_t f = first; f < last; ++f) {
+            if (!usable[f]) {
+                continue;
+            }
+            size_t length = folds[f].length;
+            double slope = 0.0;
+            double intercept = values[length - 1];
+            bool linear = prefix[length].fit(slope, intercept);
+            for (int h = 0; h < horizon; ++h) {
+                size_t target = length + static_cast<size_t>(h);
+                double actual = values[target];
+
+                size_t source = (length >= season) ? length - season + static_cast<size_t>(h) % season : length - 1;
+                scores[modelIndex(Backtester::Model::SeasonalNaive)].add(values[source] - actual);
+
+                double trend = linear ? slope * static_cast<double>(target) + intercept : values[length - 1];
+                scores[modelIndex(Backtester::Model::Linear)].add(trend - actual);
+            }
+        }
+    }
+
+    /**
+     * @brief Fit one model on every fold at once (all series, all cutoffs)
+     */
+    std::vector<Forecaster::Result> fitFolds(const std::vector<std::vector<double>>& series, const std::vector<Fold>& folds,
+                                             int horizon, int seasonLength, Forecaster::Method method, ThreadPool& pool)
+    {
+        std::vector<Forecaster::Span> prefixes;
+        prefixes.reserve(folds.size());
+        for (const Fold& fold : folds) {
+            prefixes.push_back(Forecaster::Span{series[fold.series].data(), fold.length});
+        }
+        return Forecaster::forecastAll(prefixes, seasonLength, method, horizon, pool);
+    }
+
+    /**
+     * @brief Score one fitted model on the usable folds
+     */
+    void scoreForecasts(const std::vector<std::vector<double>>& series, const std::vector<Fold>& folds,
+                        const std::vector<char>& usable, const std::vector<Forecaster::Result>& results, int horizon,
+                        Backtester::Model model, std::vector<std::vector<Backtester::Score>>& scores)
+    {
+        for (size_t f = 0; f < folds.size(); ++f) {
+            if (!usable[f]) {
+                continue;
+            }
+            const std::vector<double>& values = series[folds[f].series];
+            for (int h = 0; h < horizon; ++h) {
+                double actual = values[folds[f].length + static_cast<size_t>(h)];
+                scores[folds[f].series][modelIndex(model)].add(results[f].forecast[static_cast<size_t>(h)] - actual);
+            }
+        }
+    }
+}
+
+Backtester::Score::Score()
+    : count(0), absoluteError(0.0), squaredError(0.0) {}
+
+void Backtester::Score::add(double error) {
+    ++count;
+    absoluteError += std::fabs(error);
+    squaredError += error * error;
+}
+
+void Backtester::Score::merge(const Score& other) {
+    count += other.count;
+    absoluteError += other.absoluteError;
+    squaredError += other.squaredError;
+}
+
+double Backtester::Score::mae() const {
+    return count > 0 ? absoluteError / static_cast<double>(count) : 0.0;
+}
+
+double Backtester::Score::rmse() const {
+    return count > 0 ? std::sqrt(squaredError / static_cast<double>(count)) : 0.0;
+}
+
+// Function to run every fold of every series through each model
+Backtester::Report Backtester::run(const std::vector<std::vector<double>>& series, const std::vector<int64_t>& firstPeriods,
+                                   const std::vector<int64_t>& cutoffs, int horizon, int seasonLength, ThreadPool& pool) {
+    Report report;
+    report.scores.assign(series.size(), std::vector<Score>(MODEL_COUNT));
+    report.folds.assign(series.size(), 0);
+    if (horizon <= 0) {
+        return report;
+    }
+
+    // Folds grouped by series, so each baseline task owns a contiguous range
+    std::vector<Fold> folds;
+    std::vector<size_t> firstFold(series.size() + 1, 0);
+    for (size_t s = 0; s < series.size(); ++s) {
+        firstFold[s] = folds.size();
+        for (int64_t cutoff : cutoffs) {
+            int64_t length = cutoff - firstPeriods[s];
+            if (length < static_cast<int64_t>(MIN_TRAINING) ||
+                length + horizon > static_cast<int64_t>(series[s].size())) {
+                continue;
+            }
+            folds.push_back(Fold{s, static_cast<size_t>(length)});
+        }
+    }
+    firstFold[series.size()] = folds.size();
+
+    // Every model is scored on the same folds, or the RMSEs would not be comparable: a fold
+    // that Holt-Winters or ARIMA cannot fit is dropped for all four
+    std::vector<Forecaster::Result> holtWinters =
+        fitFolds(series, folds, horizon, seasonLength, Forecaster::Method::HoltWinters, pool);
+    std::vector<Forecaster::Result> arima = fitFolds(series, folds, horizon, seasonLength, Forecaster::Method::ARIMA, pool);
+    std::vector<char> usable(folds.size(), 0);
+    for (size_t f = 0; f < folds.size(); ++f) {
+        usable[f] = holtWinters[f].valid && arima[f].valid;
+        if (usable[f]) {
+            ++report.folds[folds[f].series];
+        } else {
+            ++report.dropped;
+        }
+    }
+
+    ThreadPool::Batch baselines;
+    for (size_t s = 0; s < series.size(); ++s) {
+        if (report.folds[s] == 0) {
+            continue;
+        }
+        pool.submit(baselines, [&, s] {
+            scoreBaselines(series[s], folds, usable, firstFold[s], firstFold[s + 1], horizon, seasonLength,
+                           report.scores[s]);
+        });
+    }
+    pool.wait(baselines);
+
+    scoreForecasts(series, folds, usable, holtWinters, horizon, Model::HoltWinters, report.scores);
+    scoreForecasts(series, folds, usable, arima, horizon, Model::ARIMA, report.scores);
+    return report;
+}
+
+const char* Backtester::modelName(Model model) {
+    switch (model) {
+        case Model::SeasonalNaive:
+            return "Naive";
+        case Model::Linear:
+            return "Linear";
+        case Model::HoltWinters:
+            return "Holt-Winters";
+        default:
+            return "ARIMA";
+    }
+}
@@ -0,0 +1,308 @@
+#include "BatchQuery.h"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include "TimeUtils.h"
+
+namespace {
+    std::string lowercase(const std::string& text)
+    {
+        std::string lower = text;
+        for (char& c : lower) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return lower;
+    }
+
+    /**
+     * @brief Whole-string decimal number; false for empty text or trailing characters
+     */
+    bool parseNumber(const std::string& text, double& value)
+    {
+        if (text.empty()) {
+            return false;
+        }
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end == text.c_str() + text.size();
+    }
+
+    /**
+     * @brief Histogram aggregate word: mean/avg/average, max, min, median or pN (0 <= N <= 100)
+     */
+    bool parseAggregate(const std::string& word, int& dataType, double& percentile)
+    {
+        if (word == "mean" || word == "avg" || word == "average") {
+            dataType = 1;
+        } else if (word == "max") {
+            dataType = 2;
+        } else if (word == "min") {
+            dataType = 3;
+        } else if (word == "median") {
+            dataType = 4;
+            percentile = 50.0;
+        } else if (word.size() > 1 && word[0] == 'p' && parseNumber(word.substr(1), percentile)) {
+            if (percentile < 0.0 || percentile > 100.0) {
+                return false;
+            }
+            dataType = 7;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Forecast model word: linear, hw/holt-winters, arima or best
+     */
+    bool parseModel(const std::string& word, bool& linear, Forecaster::Method& method)
+    {
+        if (word == "linear") {
+            linear = true;
+            return true;
+        }
+        if (word == "hw" || word == "holt-winters") {
+            method = Forecaster::Method::HoltWinters;
+        } else if (word == "arima") {
+            method = Forecaster::Method::ARIMA;
+        } else if (word == "best") {
+            method = Forecaster::Method::Best;
+        } else {
+            return false;
+        }
+        linear = false;
+        return true;
+    }
+
+    /**
+     * @brief Window bound; an end bound is inclusive, so a bare date ends after that day
+     */
+    bool parseBound(const std::string& text, bool isEnd, int64_t& epochSeconds)
+    {
+        if (!TimeUtils::parseDateTime(text, epochSeconds)) {
+            return false;
+        }
+        if (isEnd) {
+            epochSeconds += (text.size() <= 10) ? 86400 : 1;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Append `text` as a quoted JSON string
+     */
+    void appendJSONString(std::string& out, const std::string& text)
+    {
+        out += '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    /**
+     * @brief Append a number in shortest round-trip form, or null for NaN and infinities
+     */
+    void appendJSONNumber(std::string& out, double value)
+    {
+        if (!std::isfinite(value)) {
+            out += "null";
+            return;
+        }
+        char digits[32];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    std::string trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+}
+
+BatchQuery::BatchQuery()
+    : kind(Kind::Candles), granularity(WeatherRollup::Granularity::Year), dataType(1), percentile(50.0),
+      periods(0), linear(true), method(Forecaster::Method::Best), from(0), to(0) {}
+
+// Function to parse one query line into its fields
+bool BatchQuery::parse(const std::string& line, BatchQuery& query, std::string& error) {
+    std::istringstream stream(line);
+    std::vector<std::string> words;
+    std::string word;
+    while (stream >> word) {
+        words.push_back(word);
+    }
+    query = BatchQuery();
+    if (words.empty()) {
+        error = "empty query";
+        return false;
+    }
+    for (size_t i = 0; i < words.size(); ++i) {
+        query.text += (i > 0 ? " " : "") + words[i];
+    }
+
+    std::string keyword = lowercase(words[0]);
+    if (keyword == "candles" || keyword == "candle") {
+        query.kind = Kind::Candles;
+    } else if (keyword == "hist" || keyword == "histogram") {
+        query.kind = Kind::Histogram;
+    } else if (keyword == "forecast" || keyword == "predict") {
+        query.kind = Kind::Forecast;
+    } else if (keyword == "window") {
+        query.kind = Kind::Window;
+    } else {
+        error = "unknown query \"" + words[0] + "\" (expected candles, hist, forecast or window)";
+        return false;
+    }
+    if (words.size() < 2) {
+        error = "missing country code";
+        return false;
+    }
+    query.country = words[1];
+    size_t next = 2;
+
+    if (query.kind == Kind::Window) {
+        if (words.size() != 4) {
+            error = "window needs a start and an end date";
+            return false;
+        }
+        if (!parseBound(words[2], false, query.from) || !parseBound(words[3], true, query.to)) {
+            error = "dates must be given as YYYY-MM-DD or YYYY-MM-DDTHH:MM:SS";
+            return false;
+        }
+        if (query.from >= query.to) {
+            error = "the window end must not be before its start";
+            return false;
+        }
+        return true;
+    }
+
+    if (query.kind == Kind::Forecast) {
+        // Range first: the cast is only defined for values that fit an int (and NaN fails both tests)
+        double periods = 0.0;
+        if (words.size() < 3 || !parseNumber(words[2], periods) ||
+            !(periods >= 1.0 && periods <= MAX_PERIODS) || periods != std::floor(periods)) {
+            error = "forecast needs a whole number of periods from 1 to " + std::to_string(MAX_PERIODS);
+            return false;
+        }
+        query.periods = static_cast<int>(periods);
+        next = 3;
+    }
+
+    // Optional words in any order; each kind of option may be given once
+    bool haveGranularity = false;
+    bool haveOption = false;
+    for (size_t i = next; i < words.size(); ++i) {
+        std::string lower = lowercase(words[i]);
+        bool option = (query.kind == Kind::Histogram) ? parseAggregate(lower, query.dataType, query.percentile)
+                    : (query.kind == Kind::Forecast) ? parseModel(lower, query.linear, query.method)
+                    : false;
+        if (option && !haveOption) {
+            haveOption = true;
+        } else if (!option && !haveGranularity && WeatherRollup::parseGranularity(lower, query.granularity)) {
+            haveGranularity = true;
+        } else {
+            error = "unexpected \"" + words[i] + "\"";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to cut a query file or argument list into query lines
+std::vector<std::string> BatchQuery::split(const std::string& text) {
+    std::vector<std::string> queries;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream parts(line);
+        std::string part;
+        while (std::getline(parts, part, ';')) {
+            part = trim(part);
+            if (!part.empty()) {
+                queries.push_back(part);
+            }
+        }
+    }
+    return queries;
+}
+
+// Function to print a result as a tab-separated table
+std::string BatchQuery::formatText(const Result& result) const {
+    std::ostringstream out;
+    out << "# " << text << "\n";
+    if (!result.model.empty()) {
+        out << "# model: " << result.model << "\n";
+    }
+    for (size_t c = 0; c < result.columns.size(); ++c) {
+        out << (c > 0 ? "\t" : "") << result.columns[c];
+    }
+    out << "\n" << std::fixed << std::setprecision(3);
+    size_t width = result.columns.empty() ? 0 : result.columns.size() - 1;
+    for (size_t row = 0; row < result.labels.size(); ++row) {
+        out << result.labels[row];
+        for (size_t c = 0; c < width; ++c) {
+            out << "\t" << result.values[row * width + c];
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+// Function to print a result as one line of JSON
+std::string BatchQuery::formatJSON(const Result& result) const {
+    std::string out = "{\"ok\":true,\"query\":";
+    appendJSONString(out, text);
+    if (!result.model.empty()) {
+        out += ",\"model\":";
+        appendJSONString(out, result.model);
+    }
+    out += ",\"columns\":[";
+    for (size_t c = 0; c < result.columns.size(); ++c) {
+        if (c > 0) {
+            out += ',';
+        }
+        appendJSONString(out, result.columns[c]);
+    }
+    out += "],\"rows\":[";
+    size_t width = result.columns.empty() ? 0 : result.columns.size() - 1;
+    for (size_t row = 0; row < result.labels.size(); ++row) {
+        out += (row > 0) ? ",[" : "[";
+        appendJSONString(out, result.labels[row]);
+        for (size_t c = 0; c < width; ++c) {
+            out += ',';
+            appendJSONNumber(out, result.values[row * width + c]);
+        }
+        out += ']';
+    }
+    out += "]}";
+    return out;
+}
+
+std::string BatchQuery::formatError(const std::string& query, const std::string& error) {
+    std::string out = "{\"ok\":false,\"query\":";
+    appendJSONString(out, query);
+    out += ",\"error\":";
+    appendJSONString(out, error);
+    out += '}';
+    return out;
+}
@@ -22,6 +22,36 @@ std::vector<std::vector<std::string>> CSVReader::readCSV(const std::string& file
     return data; // Return the parsed CSV data
 }
 
+// Function to cut text into byte ranges that never split a line
+std::vector<std::pair<size_t, size_t>> CSVReader::splitLines(std::string_view text, unsigned parts) {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    if (parts == 0) {
+        parts = 1;
+    }
+    size_t target = text.size() / parts + 1;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = begin + target;
+        if (end >= text.size()) {
+            end = text.size();
+        } else {
+            // Move the cut forward to just past the next newline
+            size_t nl = text.find('\n', end - 1);
+            end = (nl == std::string_view::npos) ? text.size() : nl + 1;
+        }
+        chunks.emplace_back(begin, end);
+        begin = end;
+    }
+    return chunks;
+}
+
+// Function to map CSV data from a file without copying cells
+MappedCSV CSVReader::mapCSV(const std::string& filename) {
+    MappedCSV csv;
+    csv.open(filename); // Reports its own error; an unopened map is simply empty
+    return csv;
+}
+
 // Function to split a string by a given delimiter
 std::vector<std::string> CSVReader::tokenise(const std::string& str, char delimiter) {
     std::vector<std::string> tokens;
@@ -0,0 +1,211 @@
+#include "CSVScanner.h"
+#include <cstdint>
+#include "CpuFeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CSVSCANNER_X86 1
+#endif
+
+namespace {
+    /**
+     * @brief Close the line at lineEnd: drop a trailing '\r' and emit the last field
+     */
+    size_t finishLine(const char* data, size_t fieldStart, size_t lineEnd,
+                      std::vector<std::string_view>& fields)
+    {
+        size_t end = lineEnd;
+        if (end > fieldStart && data[end - 1] == '\r') {
+            --end;
+        }
+        if (fieldStart < end) {
+            fields.emplace_back(data + fieldStart, end - fieldStart);
+        }
+        return lineEnd;
+    }
+
+    /**
+     * @brief Byte-at-a-time scan from `start`, continuing a partially split line
+     */
+    size_t splitScalar(const char* data, size_t start, size_t fieldStart, size_t length, char delimiter,
+                       std::vector<std::string_view>& fields)
+    {
+        for (size_t i = start; i < length; ++i) {
+            char c = data[i];
+            if (c == delimiter) {
+                fields.emplace_back(data + fieldStart, i - fieldStart);
+                fieldStart = i + 1;
+            } else if (c == '\n') {
+                return finishLine(data, fieldStart, i, fields);
+            }
+        }
+        return finishLine(data, fieldStart, length, fields);
+    }
+
+    /**
+     * @brief Emit one field per set bit of a delimiter mask for the block at `base`
+     */
+    inline void emitFields(const char* data, size_t base, uint32_t mask, size_t& fieldStart,
+                           std::vector<std::string_view>& fields)
+    {
+        while (mask != 0) {
+            size_t pos = base + static_cast<size_t>(__builtin_ctz(mask));
+            fields.emplace_back(data + fieldStart, pos - fieldStart);
+            fieldStart = pos + 1;
+            mask &= mask - 1; // Clear lowest set bit
+        }
+    }
+
+    /**
+     * @brief Keep only the mask bits below the first newline
+     */
+    inline uint32_t bitsBefore(uint32_t mask, uint32_t newlineMask)
+    {
+        uint32_t stop = static_cast<uint32_t>(__builtin_ctz(newlineMask));
+        return stop == 0 ? 0 : mask & ((1u << stop) - 1);
+    }
+
+    /**
+     * @brief Byte-at-a-time search for the `remaining`-th delimiter before the newline
+     */
+    size_t skipScalar(const char* data, size_t start, size_t length, char delimiter, size_t remaining)
+    {
+        for (size_t i = start; i < length; ++i) {
+            if (data[i] == delimiter) {
+                if (--remaining == 0) {
+                    return i + 1;
+                }
+            } else if (data[i] == '\n') {
+                break;
+            }
+        }
+        return CSVScanner::npos;
+    }
+
+    /**
+     * @brief Position of the n-th (1-based) set bit of a mask holding at least n bits
+     */
+    inline uint32_t nthSetBit(uint32_t mask, size_t n)
+    {
+        while (--n > 0) {
+            mask &= mask - 1;
+        }
+        return static_cast<uint32_t>(__builtin_ctz(mask));
+    }
+
+#ifdef CSVSCANNER_X86
+    __attribute__((target("avx2")))
+    size_t skipAVX2(const char* data, size_t length, char delimiter, size_t remaining)
+    {
+        const __m256i delim = _mm256_set1_epi8(delimiter);
+        const __m256i newline = _mm256_set1_epi8('\n');
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t delimMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, delim)));
+            uint32_t newlineMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+            if (newlineMask != 0) {
+                delimMask = bitsBefore(delimMask, newlineMask);
+            }
+            size_t found = static_cast<size_t>(__builtin_popcount(delimMask));
+            if (found >= remaining) {
+                return i + nthSetBit(delimMask, remaining) + 1;
+            }
+            if (newlineMask != 0) {
+                return CSVScanner::npos;
+            }
+            remaining -= found;
+        }
+        return skipScalar(data, i, length, delimiter, remaining);
+    }
+
+    __attribute__((target("sse2")))
+    size_t splitSSE2(const char* data, size_t length, char delimiter, std::vector<std::string_view>& fields)
+    {
+        const __m128i delim = _mm_set1_epi8(delimiter);
+        const __m128i newline = _mm_set1_epi8('\n');
+        size_t fieldStart = 0;
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            uint32_t delimMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, delim)));
+            uint32_t newlineMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+            if (newlineMask != 0) {
+                emitFields(data, i, bitsBefore(delimMask, newlineMask), fieldStart, fields);
+                return finishLine(data, fieldStart, i + __builtin_ctz(newlineMask), fields);
+            }
+            emitFields(data, i, delimMask, fieldStart, fields);
+        }
+        return splitScalar(data, i, fieldStart, length, delimiter, fields);
+    }
+
+    __attribute__((target("avx2")))
+    size_t splitAVX2(const char* data, size_t length, char delimiter, std::vector<std::string_view>& fields)
+    {
+        const __m256i delim = _mm256_set1_epi8(delimiter);
+        const __m256i newline = _mm256_set1_epi8('\n');
+        size_t fieldStart = 0;
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t delimMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, delim)));
+            uint32_t newlineMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+            if (newlineMask != 0) {
+                emitFields(data, i, bitsBefore(delimMask, newlineMask), fieldStart, fields);
+                return finishLine(data, fieldStart, i + __builtin_ctz(newlineMask), fields);
+            }
+            emitFields(data, i, delimMask, fieldStart, fields);
+        }
+        return splitScalar(data, i, fieldStart, length, delimiter, fields);
+    }
+#endif
+}
+
+CSVScanner::Implementation CSVScanner::bestImplementation() {
+    static const Implementation best =
+        CpuFeatures::hasAVX2() ? Implementation::AVX2 :
+        CpuFeatures::hasSSE2() ? Implementation::SSE2 :
+                                 Implementation::Scalar;
+    return best;
+}
+
+const char* CSVScanner::implementationName(Implementation impl) {
+    switch (impl) {
+        case Implementation::AVX2: return "avx2";
+        case Implementation::SSE2: return "sse2";
+        default:                   return "scalar";
+    }
+}
+
+size_t CSVScanner::splitLine(const char* data, size_t length, char delimiter,
+                             std::vector<std::string_view>& fields) {
+    return splitLine(bestImplementation(), data, length, delimiter, fields);
+}
+
+size_t CSVScanner::splitLine(Implementation impl, const char* data, size_t length, char delimiter,
+                             std::vector<std::string_view>& fields) {
+    fields.clear();
+#ifdef CSVSCANNER_X86
+    if (impl == Implementation::AVX2 && CpuFeatures::hasAVX2()) {
+        return splitAVX2(data, length, delimiter, fields);
+    }
+    if (impl == Implementation::SSE2 && CpuFeatures::hasSSE2()) {
+        return splitSSE2(data, length, delimiter, fields);
+    }
+#else
+    (void)impl;
+#endif
+    return splitScalar(data, 0, 0, length, delimiter, fields);
+}
+
+size_t CSVScanner::skipFields(const char* data, size_t length, char delimiter, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+#ifdef CSVSCANNER_X86
+    if (CpuFeatures::hasAVX2()) {
+        return skipAVX2(data, length, delimiter, count);
+    }
+#endif
+    return skipScalar(data, 0, length, delimiter, count);
+}
@@ -1,4 +1,8 @@
 #include "Candlestick.h"
 
-Candlestick::Candlestick(const std::string& date_, double open_, double high_, double low_, double close_)
-    : date(date_), open(open_), high(high_), low(low_), close(close_) {}
+Candlestick::Candlestick(int64_t period_, WeatherRollup::Granularity granularity_, double open_, double high_, double low_, double close_)
+    : period(period_), granularity(granularity_), open(open_), high(high_), low(low_), close(close_) {}
+
+std::string Candlestick::label() const {
+    return WeatherRollup::periodLabel(granularity, period);
+}
@@ -4,6 +4,11 @@
 #include <sstream>
 #include <algorithm>
 #include <iostream>
+#include <cmath>
+#include "NumberParser.h"
+#include "Parallel.h"
+#include "ReduceKernels.h"
+#include "TimeUtils.h"
 
 // Structure to hold temperature data for each year
 struct TemperatureData {
@@ -18,6 +23,198 @@ struct TemperatureData {
           low(std::numeric_limits<double>::max()) {}
 };
 
+namespace {
+    /**
+     * @brief Fold one temperature into a year's aggregate
+     */
+    void addTemperature(TemperatureData& data, double temperature)
+    {
+        data.sum += temperature;
+        data.count += 1;
+        if (temperature > data.high) {
+            data.high = temperature;
+        }
+        if (temperature < data.low) {
+            data.low = temperature;
+        }
+    }
+
+    /**
+     * @brief Add one reading to the yearly aggregates
+     */
+    void accumulateReading(std::unordered_map<int, TemperatureData>& yearlyData,
+                           std::string_view timestamp, std::string_view cell)
+    {
+        // Extract the year from the timestamp
+        int64_t year = 0;
+        if (timestamp.size() < 4 || NumberParser::parseInt(timestamp.substr(0, 4), year) != NumberParser::Result::Ok) {
+            return; // Invalid timestamp or year
+        }
+
+        // Retrieve temperature data; empty and invalid cells are skipped without throwing
+        double temperature = 0.0;
+        if (NumberParser::parseDouble(cell, temperature) != NumberParser::Result::Ok) {
+            return;
+        }
+
+        addTemperature(yearlyData[static_cast<int>(year)], temperature);
+    }
+
+    /**
+     * @brief Combine two partial aggregates of the same year
+     */
+    void mergeTemperature(TemperatureData& into, const TemperatureData& from)
+    {
+        into.sum += from.sum;
+        into.count += from.count;
+        into.high = std::max(into.high, from.high);
+        into.low = std::min(into.low, from.low);
+    }
+
+    /**
+     * @brief Turn dense yearly aggregates (index 0 = firstYear) into chronologically sorted candlesticks
+     */
+    std::vector<Candlestick> buildCandlesticks(int firstYear, const std::vector<TemperatureData>& yearlyData)
+    {
+        std::vector<Candlestick> candlesticks;
+
+        double previousAverage = 0.0;
+        bool hasPrevious = false;
+
+        for (size_t i = 0; i < yearlyData.size(); ++i) {
+            int year = firstYear + static_cast<int>(i);
+            const TemperatureData& data = yearlyData[i];
+            if (data.count == 0) {
+                continue; // Skip years with no data
+            }
+
+            double average = data.sum / data.count;
+            double open = hasPrevious ? previousAverage : average; // For the first year, use its own average
+            double close = average;
+            double high = data.high;
+            double low = data.low;
+
+            candlesticks.emplace_back(year, WeatherRollup::Granularity::Year, open, high, low, close);
+
+            previousAverage = average;
+            hasPrevious = true;
+        }
+
+        return candlesticks;
+    }
+
+    /**
+     * @brief Turn sparse yearly aggregates into chronologically sorted candlesticks
+     */
+    std::vector<Candlestick> buildCandlesticks(const std::unordered_map<int, TemperatureData>& yearlyData)
+    {
+        if (yearlyData.empty()) {
+            return {};
+        }
+        int firstYear = std::numeric_limits<int>::max();
+        int lastYear = std::numeric_limits<int>::min();
+        for (const auto& pair : yearlyData) {
+            firstYear = std::min(firstYear, pair.first);
+            lastYear = std::max(lastYear, pair.first);
+        }
+
+        std::vector<TemperatureData> dense(static_cast<size_t>(lastYear - firstYear) + 1);
+        for (const auto& pair : yearlyData) {
+            dense[pair.first - firstYear] = pair.second;
+        }
+        return buildCandlesticks(firstYear, dense);
+    }
+
+    /**
+     * @brief Fold a reduced run of temperatures into a year's aggregate
+     */
+    void addSummary(TemperatureData& data, const ReduceKernels::Summary& summary)
+    {
+        if (summary.count == 0) {
+            return;
+        }
+        data.sum += summary.sum;
+        data.count += static_cast<int>(summary.count);
+        data.high = std::max(data.high, summary.max);
+        data.low = std::min(data.low, summary.min);
+    }
+
+    /**
+     * @brief Dense yearly aggregates for several columns: columns[c][year - firstYear]
+     */
+    struct YearlyAggregates {
+        int firstYear = 0;
+        std::vector<std::vector<TemperatureData>> columns;
+    };
+
+    /**
+     * @brief Aggregate the given columns by year in one pass over the rows.
+     *        Each worker folds one row block into private aggregates; the
+     *        partials are merged at the end. Missing (NaN) values are skipped.
+     */
+    YearlyAggregates aggregateByYear(const WeatherTable& table, const std::vector<size_t>& columnIndices, unsigned workers)
+    {
+        // Resolve the views first so lazily parsed columns are loaded before the workers start
+        std::vector<const double*> values;
+        for (size_t index : columnIndices) {
+            values.push_back(table.column(index));
+        }
+
+        std::vector<std::pair<size_t, size_t>> ranges =
+            Parallel::splitRange(table.rowCount(), Parallel::workerCount(workers));
+        unsigned workerCount = static_cast<unsigned>(ranges.size());
+
+        // Year runs are found once per row block, up front, and shared by every column
+        std::vector<std::vector<WeatherRollup::Run>> runs(workerCount);
+        Parallel::run(workerCount, [&](unsigned worker) {
+            runs[worker] = WeatherRollup::periodRuns(table.timestamps(), ranges[worker].first, ranges[worker].second,
+                                                     WeatherRollup::Granularity::Year, table.timestampsAscending());
+        });
+
+        YearlyAggregates result;
+        int firstYear = std::numeric_limits<int>::max();
+        int lastYear = std::numeric_limits<int>::min();
+        for (const std::vector<WeatherRollup::Run>& blockRuns : runs) {
+            for (const WeatherRollup::Run& run : blockRuns) {
+                firstYear = std::min(firstYear, static_cast<int>(run.period));
+                lastYear = std::max(lastYear, static_cast<int>(run.period));
+            }
+        }
+        if (firstYear > lastYear) {
+            result.columns.assign(columnIndices.size(), std::vector<TemperatureData>());
+            return result;
+        }
+        result.firstYear = firstYear;
+        size_t yearCount = static_cast<size_t>(lastYear - firstYear) + 1;
+
+        std::vector<std::vector<std::vector<TemperatureData>>> partial(workerCount);
+        Parallel::run(workerCount, [&](unsigned worker) {
+            std::vector<std::vector<TemperatureData>>& aggregates = partial[worker];
+            aggregates.assign(values.size(), std::vector<TemperatureData>(yearCount));
+            for (size_t c = 0; c < values.size(); ++c) {
+                const double* temperatures = values[c];
+                // One kernel call reduces each same-year run
+                for (const WeatherRollup::Run& run : runs[worker]) {
+                    ReduceKernels::Summary summary;
+                    ReduceKernels::reduce(temperatures + run.begin, run.end - run.begin, summary);
+                    addSummary(aggregates[c][static_cast<size_t>(run.period - firstYear)], summary);
+                }
+            }
+        });
+
+        // Merge in row-block order
+        result.columns = std::move(partial[0]);
+        for (unsigned worker = 1; worker < workerCount; ++worker) {
+            for (size_t c = 0; c < result.columns.size(); ++c) {
+                for (size_t y = 0; y < yearCount; ++y) {
+                    mergeTemperature(result.columns[c][y], partial[worker][c][y]);
+                }
+            }
+        }
+        return result;
+    }
+}
+
 // Function to compute candlestick data from CSV data for a given country
 std::vector<Candlestick> CandlestickCalculator::computeCandlestickData(const std::vector<std::vector<std::string>>& csvData, const std::string& countryCode) {
     std::vector<Candlestick> candlesticks;
@@ -52,67 +249,41 @@ std::vector<Candlestick> CandlestickCalculator::computeCandlestickData(const std
         if (static_cast<int>(row.size()) <= targetIndex) {
             continue; // If the specified column does not exist
         }
+        accumulateReading(yearlyData, row[0], row[targetIndex]);
+    }
 
-        // Extract the year from the timestamp
-        std::string timestamp = row[0];
-        if (timestamp.size() < 4) {
-            continue; // Invalid timestamp
-        }
-        int year = 0;
-        try {
-            year = std::stoi(timestamp.substr(0, 4));
-        } catch (...) {
-            continue; // Invalid year
-        }
+    return buildCandlesticks(yearlyData);
+}
 
-        // Retrieve temperature data
-        double temperature = 0.0;
-        try {
-            temperature = std::stod(row[targetIndex]);
-        } catch (...) {
-            continue; // Invalid temperature data
-        }
+// Function to compute candlestick data for a given country from a rollup level
+std::vector<Candlestick> CandlestickCalculator::computeCandlestickData(const WeatherTable& table, const WeatherRollup& rollup,
+                                                                      const std::string& countryCode, WeatherRollup::Granularity granularity) {
+    std::vector<Candlestick> candlesticks;
 
-        // Update yearly data
-        TemperatureData& data = yearlyData[year];
-        data.sum += temperature;
-        data.count += 1;
-        if (temperature > data.high) {
-            data.high = temperature;
-        }
-        if (temperature < data.low) {
-            data.low = temperature;
-        }
+    int targetIndex = table.schema().columnIndex(countryCode, WeatherSchema::TEMPERATURE);
+    if (targetIndex == -1) {
+        std::cerr << "Error: Country code " << countryCode << " not found in headers." << std::endl;
+        return candlesticks;
     }
-
-    // Create a list of years to sort
-    std::vector<int> years;
-    for (const auto& pair : yearlyData) {
-        years.push_back(pair.first);
+    const WeatherRollup::Bucket* buckets = rollup.buckets(granularity, static_cast<size_t>(targetIndex));
+    if (buckets == nullptr) {
+        std::cerr << "Error: No rollup available for " << countryCode << "." << std::endl;
+        return candlesticks;
     }
-    std::sort(years.begin(), years.end());
 
     double previousAverage = 0.0;
     bool hasPrevious = false;
 
-    for (size_t i = 0; i < years.size(); ++i) {
-        int year = years[i];
-        TemperatureData& data = yearlyData[year];
-        if (data.count == 0) {
-            continue; // Skip years with no data
+    for (size_t i = 0; i < rollup.bucketCount(granularity); ++i) {
+        const WeatherRollup::Bucket& bucket = buckets[i];
+        if (bucket.count == 0) {
+            continue; // Skip periods with no data
         }
 
-        double average = data.sum / data.count;
-        double open = hasPrevious ? previousAverage : average; // For the first year, use its own average
-        double close = average;
-        double high = data.high;
-        double low = data.low;
-
-        // Set the year in "YYYY" format
-        std::string yearStr = std::to_string(year);
-
-        Candlestick candle(yearStr, open, high, low, close);
-        candlesticks.push_back(candle);
+        double average = bucket.mean();
+        double open = hasPrevious ? previousAverage : average; // For the first period, use its own average
+        int64_t period = rollup.firstPeriod(granularity) + static_cast<int64_t>(i);
+        candlesticks.emplace_back(period, granularity, open, bucket.max, bucket.min, average);
 
         previousAverage = average;
         hasPrevious = true;
@@ -120,3 +291,37 @@ std::vector<Candlestick> CandlestickCalculator::computeCandlestickData(const std
 
     return candlesticks;
 }
+
+// Function to compute candlestick data for every country's temperature column in one scan
+std::map<std::string, std::vector<Candlestick>> CandlestickCalculator::computeAllCandlestickData(const WeatherTable& table, unsigned workers) {
+    std::map<std::string, std::vector<Candlestick>> candlesByCountry;
+
+    if (table.empty()) {
+        std::cerr << "Error: CSV data is empty." << std::endl;
+        return candlesByCountry;
+    }
+
+    const WeatherSchema& schema = table.schema();
+    std::vector<std::string> countries;
+    std::vector<size_t> columns;
+    for (const std::string& country : schema.countries()) {
+        int index = schema.columnIndex(country, WeatherSchema::TEMPERATURE);
+        if (index != -1) {
+            countries.push_back(country);
+            columns.push_back(static_cast<size_t>(index));
+        }
+    }
+    if (columns.empty()) {
+        std::cerr << "Error: No temperature columns found in headers." << std::endl;
+        return candlesByCountry;
+    }
+
+    YearlyAggregates yearly = aggregateByYear(table, columns, workers);
+    for (size_t i = 0; i < countries.size(); ++i) {
+        std::vector<Candlestick> candles = buildCandlesticks(yearly.firstYear, yearly.columns[i]);
+        if (!candles.empty()) {
+            candlesByCountry[countries[i]] = std::move(candles);
+        }
+    }
+    return candlesByCountry;
+}
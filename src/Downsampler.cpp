@@ -0,0 +1,125 @@
+#include "Downsampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Start of slice `i` when `count` items are cut into `slices` near-equal slices
+     */
+    size_t sliceStart(size_t i, size_t count, size_t slices)
+    {
+        return static_cast<size_t>(static_cast<unsigned long long>(i) * count / slices);
+    }
+
+    std::vector<size_t> allIndices(size_t count)
+    {
+        std::vector<size_t> indices(count);
+        for (size_t i = 0; i < count; ++i) {
+            indices[i] = i;
+        }
+        return indices;
+    }
+}
+
+// Function to pick the points of largest effective triangle area, one per bucket
+std::vector<size_t> Downsampler::lttb(const double* x, const double* y, size_t count, size_t threshold) {
+    if (count <= threshold) {
+        return allIndices(count);
+    }
+    std::vector<size_t> indices;
+    if (threshold == 0) {
+        return indices;
+    }
+    indices.reserve(threshold);
+    indices.push_back(0);
+    if (threshold == 1) {
+        return indices;
+    }
+
+    // Points 1..count-2 are cut into threshold - 2 buckets; each contributes one point
+    size_t inner = count - 2;
+    size_t buckets = threshold - 2;
+    size_t previous = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        size_t begin = 1 + sliceStart(b, inner, buckets);
+        size_t end = 1 + sliceStart(b + 1, inner, buckets);
+
+        // Third vertex: the average of the next bucket (the last point after the final bucket)
+        size_t nextBegin = end;
+        size_t nextEnd = (b + 1 < buckets) ? 1 + sliceStart(b + 2, inner, buckets) : count;
+        double averageX = 0.0;
+        double averageY = 0.0;
+        for (size_t i = nextBegin; i < nextEnd; ++i) {
+            averageX += x[i];
+            averageY += y[i];
+        }
+        double span = static_cast<double>(nextEnd - nextBegin);
+        averageX /= span;
+        averageY /= span;
+
+        double ax = x[previous];
+        double ay = y[previous];
+        size_t chosen = begin;
+        double largest = -1.0;
+        for (size_t i = begin; i < end; ++i) {
+            double area = std::fabs((ax - averageX) * (y[i] - ay) - (ax - x[i]) * (averageY - ay));
+            if (area > largest) {
+                largest = area;
+                chosen = i;
+            }
+        }
+        indices.push_back(chosen);
+        previous = chosen;
+    }
+    indices.push_back(count - 1);
+    return indices;
+}
+
+// Function to keep each bucket's lowest and highest point in time order
+std::vector<size_t> Downsampler::minMax(const double* y, size_t count, size_t buckets) {
+    if (count <= 2 * buckets) {
+        return allIndices(count);
+    }
+    std::vector<size_t> indices;
+    indices.reserve(2 * buckets);
+    for (size_t b = 0; b < buckets; ++b) {
+        size_t begin = sliceStart(b, count, buckets);
+        size_t end = sliceStart(b + 1, count, buckets);
+        size_t lowest = begin;
+        size_t highest = begin;
+        for (size_t i = begin + 1; i < end; ++i) {
+            if (y[i] < y[lowest]) lowest = i;
+            if (y[i] > y[highest]) highest = i;
+        }
+        indices.push_back(std::min(lowest, highest));
+        if (lowest != highest) {
+            indices.push_back(std::max(lowest, highest));
+        }
+    }
+    return indices;
+}
+
+// Function to merge runs of consecutive candles into wider ones
+std::vector<Candlestick> Downsampler::candles(const std::vector<Candlestick>& candles, size_t maxCount) {
+    if (candles.size() <= maxCount) {
+        return candles;
+    }
+    std::vector<Candlestick> merged;
+    if (maxCount == 0) {
+        return merged;
+    }
+    merged.reserve(maxCount);
+    for (size_t b = 0; b < maxCount; ++b) {
+        size_t begin = sliceStart(b, candles.size(), maxCount);
+        size_t end = sliceStart(b + 1, candles.size(), maxCount);
+        const Candlestick& first = candles[begin];
+        double high = first.high;
+        double low = first.low;
+        for (size_t i = begin + 1; i < end; ++i) {
+            high = std::max(high, candles[i].high);
+            low = std::min(low, candles[i].low);
+        }
+        merged.emplace_back(first.period, first.granularity, first.open, high, low, candles[end - 1].close);
+    }
+    return merged;
+}
@@ -0,0 +1,256 @@
+#include "Exporter.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const size_t BUFFER_BYTES = 1 << 20;
+    const char MAGIC[8] = {'W', 'X', 'C', 'O', 'L', 'S', '0', '1'};
+
+    /**
+     * @brief True if a CSV field must be quoted
+     */
+    bool needsQuotes(std::string_view value)
+    {
+        return value.find_first_of(",\"\r\n") != std::string_view::npos;
+    }
+}
+
+Exporter::Exporter()
+    : format(Format::CSV), used(0), field(0), recordCount(0), written(0), failed(false), blockRows(0) {}
+
+Exporter::~Exporter() {
+    if (out.is_open()) {
+        close();
+    }
+}
+
+bool Exporter::open(const std::string& filename, Format format_, const std::vector<Column>& columns_) {
+    if (out.is_open()) {
+        close();
+    }
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    format = format_;
+    columns = columns_;
+    buffer.resize(BUFFER_BYTES);
+    used = 0;
+    field = 0;
+    recordCount = 0;
+    written = 0;
+    failed = false;
+    blockRows = 0;
+    blockColumns.assign(columns.size(), std::vector<char>());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (format == Format::Binary && columns[i].type != Type::Text) {
+            blockColumns[i].reserve(BLOCK_ROWS * sizeof(double));
+        }
+    }
+
+    if (format == Format::CSV) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (i > 0) {
+                append(",", 1);
+            }
+            append(columns[i].name.data(), columns[i].name.size());
+        }
+        append("\n", 1);
+    } else if (format == Format::Binary) {
+        appendRaw(MAGIC, sizeof(MAGIC));
+        uint32_t count = static_cast<uint32_t>(columns.size());
+        appendRaw(&count, sizeof(count));
+        for (const Column& column : columns) {
+            uint8_t type = static_cast<uint8_t>(column.type);
+            uint16_t length = static_cast<uint16_t>(std::min<size_t>(column.name.size(), UINT16_MAX));
+            appendRaw(&type, sizeof(type));
+            appendRaw(&length, sizeof(length));
+            append(column.name.data(), length);
+        }
+    }
+    return true;
+}
+
+void Exporter::beginField() {
+    if (format == Format::CSV) {
+        if (field > 0) {
+            append(",", 1);
+        }
+        return;
+    }
+    // JSON lines: {"name":value,...
+    append(field == 0 ? "{\"" : ",\"", 2);
+    const std::string& name = columns[field].name;
+    append(name.data(), name.size());
+    append("\":", 2);
+}
+
+void Exporter::integer(int64_t value) {
+    if (format == Format::Binary) {
+        std::vector<char>& column = blockColumns[field];
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        column.insert(column.end(), bytes, bytes + sizeof(value));
+    } else {
+        beginField();
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+    ++field;
+}
+
+void Exporter::real(double value) {
+    if (format == Format::Binary) {
+        std::vector<char>& column = blockColumns[field];
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        column.insert(column.end(), bytes, bytes + sizeof(value));
+    } else {
+        beginField();
+        if (std::isnan(value)) {
+            if (format == Format::JSONLines) {
+                append("null", 4);
+            }
+        } else {
+            char digits[32];
+            std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+            append(digits, static_cast<size_t>(result.ptr - digits));
+        }
+    }
+    ++field;
+}
+
+void Exporter::text(std::string_view value) {
+    if (format == Format::Binary) {
+        std::vector<char>& column = blockColumns[field];
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+        const char* bytes = reinterpret_cast<const char*>(&length);
+        column.insert(column.end(), bytes, bytes + sizeof(length));
+        column.insert(column.end(), value.data(), value.data() + length);
+        ++field;
+        return;
+    }
+
+    beginField();
+    if (format == Format::CSV && !needsQuotes(value)) {
+        append(value.data(), value.size());
+    } else if (format == Format::CSV) {
+        append("\"", 1);
+        for (char c : value) {
+            append(&c, 1);
+            if (c == '"') {
+                append("\"", 1); // Quotes are doubled
+            }
+        }
+        append("\"", 1);
+    } else {
+        append("\"", 1);
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                char escaped[2] = {'\\', c};
+                append(escaped, 2);
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                append(escaped, 6);
+            } else {
+                append(&c, 1);
+            }
+        }
+        append("\"", 1);
+    }
+    ++field;
+}
+
+void Exporter::endRecord() {
+    if (format == Format::CSV) {
+        append("\n", 1);
+    } else if (format == Format::JSONLines) {
+        append("}\n", 2);
+    } else if (++blockRows == BLOCK_ROWS) {
+        writeBlock();
+    }
+    field = 0;
+    ++recordCount;
+}
+
+void Exporter::writeBlock() {
+    uint32_t rows = static_cast<uint32_t>(blockRows);
+    appendRaw(&rows, sizeof(rows));
+    for (std::vector<char>& column : blockColumns) {
+        append(column.data(), column.size());
+        column.clear();
+    }
+    blockRows = 0;
+}
+
+void Exporter::append(const char* data, size_t size) {
+    if (used + size > buffer.size()) {
+        flush();
+        if (size > buffer.size()) {
+            out.write(data, static_cast<std::streamsize>(size));
+            written += size;
+            failed = failed || !out;
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, data, size);
+    used += size;
+}
+
+void Exporter::flush() {
+    if (used == 0) {
+        return;
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(used));
+    written += used;
+    used = 0;
+    failed = failed || !out;
+}
+
+// Function to finish the file: last block and end marker, then the buffered bytes
+bool Exporter::close() {
+    if (!out.is_open()) {
+        return !failed;
+    }
+    if (format == Format::Binary) {
+        if (blockRows > 0) {
+            writeBlock();
+        }
+        uint32_t end = 0;
+        appendRaw(&end, sizeof(end));
+    }
+    flush();
+    out.close();
+    failed = failed || !out;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    blockColumns.clear();
+    return !failed;
+}
+
+bool Exporter::parseFormat(const std::string& text, Format& format) {
+    if (text == "csv") {
+        format = Format::CSV;
+    } else if (text == "jsonl" || text == "json") {
+        format = Format::JSONLines;
+    } else if (text == "bin" || text == "binary") {
+        format = Format::Binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* Exporter::extension(Format format) {
+    switch (format) {
+        case Format::JSONLines:
+            return "jsonl";
+        case Format::Binary:
+            return "bin";
+        default:
+            return "csv";
+    }
+}
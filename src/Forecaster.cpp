@@ -0,0 +1,724 @@
+#include "Forecaster.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+    const double INFEASIBLE = std::numeric_limits<double>::max();
+
+    // Holt-Winters smoothing grid; gamma is only searched for seasonal series
+    const double ALPHAS[] = {0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+    const double BETAS[] = {0.0, 0.01, 0.05, 0.1, 0.2, 0.3};
+    const double GAMMAS[] = {0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+
+    // ARIMA orders tried: p, q in 0..2, with d in 0..1 chosen per series by the KPSS test
+    const int MAX_AR = 2;
+    const int MAX_DIFF = 1;
+    const int MAX_MA = 2;
+
+    // Nelder-Mead iterations allowed per parameter
+    const int ITERATIONS_PER_PARAMETER = 80;
+
+    // KPSS level-stationarity test at the 5% level: above this the series is differenced
+    const double KPSS_CRITICAL_VALUE = 0.463;
+
+    /**
+     * @brief Akaike information criterion from a sum of squared one-step errors
+     */
+    double aicOf(double sse, size_t count, int parameters)
+    {
+        double n = static_cast<double>(count);
+        return n * std::log(std::max(sse, 1e-12) / n) + 2.0 * parameters;
+    }
+
+    /**
+     * @brief KPSS statistic for level stationarity: squared partial sums of the demeaned
+     *        series over n^2 times the Bartlett long-run variance, with the short lag
+     *        trunc(4 (n/100)^0.25). Large values mean the level wanders (a unit root)
+     */
+    double kpssStatistic(const std::vector<double>& x)
+    {
+        size_t n = x.size();
+        double mean = 0.0;
+        for (double value : x) mean += value;
+        mean /= static_cast<double>(n);
+
+        double partialSum = 0.0;
+        double sumOfSquares = 0.0;
+        double variance = 0.0;
+        for (double value : x) {
+            partialSum += value - mean;
+            sumOfSquares += partialSum * partialSum;
+            variance += (value - mean) * (value - mean);
+        }
+        size_t lags = static_cast<size_t>(4.0 * std::pow(static_cast<double>(n) / 100.0, 0.25));
+        for (size_t lag = 1; lag <= lags && lag < n; ++lag) {
+            double covariance = 0.0;
+            for (size_t t = lag; t < n; ++t) {
+                covariance += (x[t] - mean) * (x[t - lag] - mean);
+            }
+            variance += 2.0 * (1.0 - static_cast<double>(lag) / static_cast<double>(lags + 1)) * covariance;
+        }
+        variance /= static_cast<double>(n);
+        if (variance <= 0.0) {
+            return 0.0; // Constant series: nothing to difference
+        }
+        return sumOfSquares / (static_cast<double>(n) * static_cast<double>(n) * variance);
+    }
+
+    /**
+     * @brief Level and trend after a Holt-Winters pass; the season lives in the caller's buffer
+     */
+    struct SmoothingState {
+        double level = 0.0;
+        double trend = 0.0;
+    };
+
+    /**
+     * @brief Initial Holt-Winters state: level = mean of the first season, trend = per-period
+     *        change between the first two seasons, indices = first season minus the level.
+     *        Without a season (m = 1) the first difference is the trend. Returns the first
+     *        time step to smooth.
+     */
+    size_t initialState(const double* y, int m, double* season, SmoothingState& state)
+    {
+        if (m <= 1) {
+            season[0] = 0.0;
+            state.level = y[0];
+            state.trend = y[1] - y[0];
+            return 1;
+        }
+        double first = 0.0;
+        double second = 0.0;
+        for (int i = 0; i < m; ++i) {
+            first += y[i];
+            second += y[m + i];
+        }
+        first /= m;
+        second /= m;
+        state.level = first;
+        state.trend = (second - first) / m;
+        for (int i = 0; i < m; ++i) {
+            season[i] = y[i] - first;
+        }
+        return static_cast<size_t>(m);
+    }
+
+    /**
+     * @brief Additive Holt-Winters over y[0, n) with season length m (1 = Holt's linear trend).
+     *        Returns the sum of squared one-step errors; `season` (m values) is scratch space
+     *        and ends holding the final seasonal indices. No allocation.
+     */
+    double holtWinters(const double* y, size_t n, int m, double alpha, double beta, double gamma,
+                       double* season, SmoothingState& state, size_t& count)
+    {
+        size_t start = initialState(y, m, season, state);
+        double sse = 0.0;
+        size_t slot = start % static_cast<size_t>(m);
+        for (size_t t = start; t < n; ++t) {
+            double s = season[slot];
+            double error = y[t] - (state.level + state.trend + s);
+            sse += error * error;
+            double level = alpha * (y[t] - s) + (1.0 - alpha) * (state.level + state.trend);
+            state.trend = beta * (level - state.level) + (1.0 - beta) * state.trend;
+            state.level = level;
+            season[slot] = gamma * (y[t] - level) + (1.0 - gamma) * s;
+            if (++slot == static_cast<size_t>(m)) {
+                slot = 0;
+            }
+        }
+        count = n - start;
+        return sse;
+    }
+
+    // Parameter sets smoothed side by side in one pass
+    const size_t LANES = 4;
+
+    /**
+     * @brief holtWinters() for LANES (beta, gamma) pairs at once. Each step of one recursion
+     *        waits on the previous one; interleaving independent lanes keeps the FPU busy.
+     *        `season` is scratch of m * LANES values, slot-major. Writes each lane's SSE.
+     */
+    void holtWintersLanes(const double* y, size_t n, int m, double alpha, const double* beta, const double* gamma,
+                          double* season, double* sse, size_t& count)
+    {
+        SmoothingState initial;
+        size_t start = initialState(y, m, season, initial);
+        for (size_t i = static_cast<size_t>(m); i > 0; --i) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                season[(i - 1) * LANES + lane] = season[i - 1];
+            }
+        }
+        double level[LANES];
+        double trend[LANES];
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            level[lane] = initial.level;
+            trend[lane] = initial.trend;
+            sse[lane] = 0.0;
+        }
+
+        size_t slot = start % static_cast<size_t>(m);
+        for (size_t t = start; t < n; ++t) {
+            double* s = season + slot * LANES;
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                double error = y[t] - (level[lane] + trend[lane] + s[lane]);
+                sse[lane] += error * error;
+                double next = alpha * (y[t] - s[lane]) + (1.0 - alpha) * (level[lane] + trend[lane]);
+                trend[lane] = beta[lane] * (next - level[lane]) + (1.0 - beta[lane]) * trend[lane];
+                level[lane] = next;
+                s[lane] = gamma[lane] * (y[t] - next) + (1.0 - gamma[lane]) * s[lane];
+            }
+            if (++slot == static_cast<size_t>(m)) {
+                slot = 0;
+            }
+        }
+        count = n - start;
+    }
+
+    /**
+     * @brief Conditional sum of squares of an ARMA(P, Q) with constant on w[0, len).
+     *        The orders are template parameters so the lag loops unroll.
+     */
+    template <int P, int Q>
+    double armaSumOfSquares(const double* params, const double* w, size_t len, double* residuals)
+    {
+        const size_t start = static_cast<size_t>(P);
+        double sse = 0.0;
+        for (size_t t = 0; t < len; ++t) {
+            if (t < start) {
+                residuals[t] = 0.0;
+                continue;
+            }
+            double predicted = params[0];
+            for (int i = 1; i <= P; ++i) {
+                predicted += params[i] * w[t - i];
+            }
+            for (int j = 1; j <= Q; ++j) {
+                if (static_cast<size_t>(j) <= t) {
+                    predicted += params[P + j] * residuals[t - j];
+                }
+            }
+            double error = w[t] - predicted;
+            residuals[t] = error;
+            sse += error * error;
+        }
+        return sse;
+    }
+
+    /**
+     * @brief CSS objective of one ARMA(p, q) order on w[0, len).
+     *        params = [c, phi_1..phi_p, theta_1..theta_q]; residuals (len values) is scratch.
+     *        Coefficients outside a safe stationary/invertible box are rejected.
+     */
+    struct ArmaObjective {
+        const double* w;
+        size_t len;
+        int p;
+        int q;
+        double* residuals;
+
+        double operator()(const double* params) const
+        {
+            double arSum = 0.0;
+            double maSum = 0.0;
+            for (int i = 0; i < p; ++i) {
+                arSum += std::fabs(params[1 + i]);
+            }
+            for (int j = 0; j < q; ++j) {
+                maSum += std::fabs(params[1 + p + j]);
+            }
+            if (arSum >= 0.99 || maSum >= 0.99) {
+                return INFEASIBLE;
+            }
+
+            switch (p * (MAX_MA + 1) + q) {
+                case 0: return armaSumOfSquares<0, 0>(params, w, len, residuals);
+                case 1: return armaSumOfSquares<0, 1>(params, w, len, residuals);
+                case 2: return armaSumOfSquares<0, 2>(params, w, len, residuals);
+                case 3: return armaSumOfSquares<1, 0>(params, w, len, residuals);
+                case 4: return armaSumOfSquares<1, 1>(params, w, len, residuals);
+                case 5: return armaSumOfSquares<1, 2>(params, w, len, residuals);
+                case 6: return armaSumOfSquares<2, 0>(params, w, len, residuals);
+                case 7: return armaSumOfSquares<2, 1>(params, w, len, residuals);
+                default: return armaSumOfSquares<2, 2>(params, w, len, residuals);
+            }
+        }
+    };
+
+    /**
+     * @brief Nelder-Mead simplex minimiser; all buffers are sized once at construction
+     */
+    class NelderMead {
+    public:
+        explicit NelderMead(size_t dimension)
+            : k(dimension), simplex((dimension + 1) * dimension), values(dimension + 1),
+              centroid(dimension), reflected(dimension), trial(dimension) {}
+
+        // Minimise f from x (updated in place) with initial edge lengths `steps`; returns f(x)
+        template <typename F>
+        double minimise(const F& f, double* x, const double* steps, int maxIterations)
+        {
+            for (size_t v = 0; v <= k; ++v) {
+                double* vertex = point(v);
+                std::copy(x, x + k, vertex);
+                if (v > 0) {
+                    vertex[v - 1] += steps[v - 1];
+                }
+                values[v] = f(vertex);
+            }
+
+            for (int iteration = 0; iteration < maxIterations; ++iteration) {
+                size_t best = 0;
+                size_t worst = 0;
+                for (size_t v = 1; v <= k; ++v) {
+                    if (values[v] < values[best]) best = v;
+                    if (values[v] > values[worst]) worst = v;
+                }
+                size_t secondWorst = best;
+                for (size_t v = 0; v <= k; ++v) {
+                    if (v != worst && values[v] > values[secondWorst]) secondWorst = v;
+                }
+                if (values[worst] - values[best] <= 1e-8 * std::fabs(values[best]) + 1e-14) {
+                    break;
+                }
+
+                std::fill(centroid.begin(), centroid.end(), 0.0);
+                for (size_t v = 0; v <= k; ++v) {
+                    if (v == worst) continue;
+                    for (size_t i = 0; i < k; ++i) {
+                        centroid[i] += point(v)[i] / static_cast<double>(k);
+                    }
+                }
+
+                double* w = point(worst);
+                moveFrom(centroid.data(), w, 1.0, reflected.data());
+                double reflectedValue = f(reflected.data());
+                if (reflectedValue < values[best]) {
+                    moveFrom(centroid.data(), w, 2.0, trial.data());
+                    double expandedValue = f(trial.data());
+                    if (expandedValue < reflectedValue) {
+                        replace(worst, trial.data(), expandedValue);
+                    } else {
+                        replace(worst, reflected.data(), reflectedValue);
+                    }
+                } else if (reflectedValue < values[secondWorst]) {
+                    replace(worst, reflected.data(), reflectedValue);
+                } else {
+                    moveFrom(centroid.data(), w, -0.5, trial.data());
+                    double contractedValue = f(trial.data());
+                    if (contractedValue < values[worst]) {
+                        replace(worst, trial.data(), contractedValue);
+                    } else {
+                        // Shrink every vertex halfway towards the best one
+                        for (size_t v = 0; v <= k; ++v) {
+                            if (v == best) continue;
+                            for (size_t i = 0; i < k; ++i) {
+                                point(v)[i] = 0.5 * (point(v)[i] + point(best)[i]);
+                            }
+                            values[v] = f(point(v));
+                        }
+                    }
+                }
+            }
+
+            size_t best = 0;
+            for (size_t v = 1; v <= k; ++v) {
+                if (values[v] < values[best]) best = v;
+            }
+            std::copy(point(best), point(best) + k, x);
+            return values[best];
+        }
+
+    private:
+        double* point(size_t v) { return simplex.data() + v * k; }
+
+        // out = centroid + factor * (centroid - from)
+        void moveFrom(const double* c, const double* from, double factor, double* out) const
+        {
+            for (size_t i = 0; i < k; ++i) {
+                out[i] = c[i] + factor * (c[i] - from[i]);
+            }
+        }
+
+        void replace(size_t v, const double* x, double value)
+        {
+            std::copy(x, x + k, point(v));
+            values[v] = value;
+        }
+
+        size_t k;
+        std::vector<double> simplex;
+        std::vector<double> values;
+        std::vector<double> centroid;
+        std::vector<double> reflected;
+        std::vector<double> trial;
+    };
+
+    /**
+     * @brief Best smoothing parameters found in one alpha row of the grid
+     */
+    struct HoltWintersCandidate {
+        double sse = INFEASIBLE;
+        size_t count = 0;
+        double alpha = 0.0;
+        double beta = 0.0;
+        double gamma = 0.0;
+    };
+
+    /**
+     * @brief Fitted ARMA coefficients of one (p, d, q) order
+     */
+    struct ArimaCandidate {
+        bool valid = false;
+        int p = 0;
+        int d = 0;
+        int q = 0;
+        double sse = INFEASIBLE;
+        size_t count = 0;
+        double aic = INFEASIBLE;
+        std::vector<double> params;
+    };
+
+    /**
+     * @brief One series prepared for fitting, and the candidate slots its tasks write to
+     */
+    struct SeriesWork {
+        Forecaster::Span values = {nullptr, 0};
+        int season = 1;                           // Season length actually used
+        std::vector<double> seasonMeans;          // Per-slot mean removed before ARIMA
+        std::vector<double> differenced[MAX_DIFF + 1]; // Deseasonalised series, differenced d times
+        int difference = 0;                       // d chosen by the KPSS test; ARIMA orders share it
+        std::vector<HoltWintersCandidate> holtWinters;
+        std::vector<ArimaCandidate> arima;
+    };
+
+    int holtWintersParameters(int season)
+    {
+        // Smoothing weights plus the initial level, trend and seasonal indices
+        return season > 1 ? 3 + 2 + season : 2 + 2;
+    }
+
+    void fitHoltWintersRow(const SeriesWork& work, double alpha, HoltWintersCandidate& out)
+    {
+        const Forecaster::Span& y = work.values;
+        int m = work.season;
+        size_t gammaCount = (m > 1) ? sizeof(GAMMAS) / sizeof(GAMMAS[0]) : 1;
+        size_t combinations = (sizeof(BETAS) / sizeof(BETAS[0])) * gammaCount;
+        std::vector<double> season(static_cast<size_t>(m) * LANES);
+
+        // Grid points in batches of LANES; a short last batch repeats its final point
+        double beta[LANES];
+        double gamma[LANES];
+        double sse[LANES];
+        for (size_t first = 0; first < combinations; first += LANES) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                size_t index = std::min(first + lane, combinations - 1);
+                beta[lane] = BETAS[index / gammaCount];
+                gamma[lane] = (m > 1) ? GAMMAS[index % gammaCount] : 0.0;
+            }
+            size_t count = 0;
+            holtWintersLanes(y.values, y.count, m, alpha, beta, gamma, season.data(), sse, count);
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                if (sse[lane] < out.sse) {
+                    out.sse = sse[lane];
+                    out.count = count;
+                    out.alpha = alpha;
+                    out.beta = beta[lane];
+                    out.gamma = gamma[lane];
+                }
+            }
+        }
+    }
+
+    void fitArimaOrder(const SeriesWork& work, ArimaCandidate& out)
+    {
+        const std::vector<double>& w = work.differenced[out.d];
+        size_t k = static_cast<size_t>(1 + out.p + out.q);
+        int seasonal = work.season > 1 ? work.season : 0;
+        if (w.size() < static_cast<size_t>(out.p) + k + seasonal + 2) {
+            return; // Too short for this order
+        }
+
+        double mean = 0.0;
+        for (double value : w) mean += value;
+        mean /= static_cast<double>(w.size());
+        double variance = 0.0;
+        for (double value : w) variance += (value - mean) * (value - mean);
+        double deviation = std::sqrt(variance / static_cast<double>(w.size()));
+
+        std::vector<double> residuals(w.size());
+        ArmaObjective objective{w.data(), w.size(), out.p, out.q, residuals.data()};
+        std::vector<double> params(k, 0.0);
+        std::vector<double> steps(k, 0.1);
+        params[0] = mean;
+        steps[0] = 0.1 * deviation + 1e-3;
+
+        NelderMead optimiser(k);
+        double sse = optimiser.minimise(objective, params.data(), steps.data(),
+                                        ITERATIONS_PER_PARAMETER * static_cast<int>(k));
+        if (sse >= INFEASIBLE) {
+            return;
+        }
+        out.valid = true;
+        out.sse = sse;
+        out.count = w.size() - static_cast<size_t>(out.p);
+        out.aic = aicOf(sse, out.count, static_cast<int>(k) + seasonal);
+        out.params = params;
+    }
+
+    Forecaster::Result holtWintersResult(const SeriesWork& work, const HoltWintersCandidate& best, int horizon)
+    {
+        Forecaster::Result result;
+        const Forecaster::Span& y = work.values;
+        int m = work.season;
+        std::vector<double> season(static_cast<size_t>(m));
+        SmoothingState state;
+        size_t count = 0;
+        holtWinters(y.values, y.count, m, best.alpha, best.beta, best.gamma, season.data(), state, count);
+
+        for (int h = 1; h <= horizon; ++h) {
+            size_t slot = (y.count - 1 + static_cast<size_t>(h)) % static_cast<size_t>(m);
+            result.forecast.push_back(state.level + h * state.trend + season[slot]);
+        }
+
+        std::ostringstream name;
+        name << std::fixed << std::setprecision(2) << "HW(a=" << best.alpha << ",b=" << best.beta;
+        if (m > 1) {
+            name << ",g=" << best.gamma << ",m=" << m;
+        }
+        name << ")";
+        result.valid = true;
+        result.method = Forecaster::Method::HoltWinters;
+        result.model = name.str();
+        result.rmse = std::sqrt(best.sse / static_cast<double>(best.count));
+        result.aic = aicOf(best.sse, best.count, holtWintersParameters(m));
+        return result;
+    }
+
+    Forecaster::Result arimaResult(const SeriesWork& work, const ArimaCandidate& best, int horizon)
+    {
+        Forecaster::Result result;
+        const std::vector<double>& w = work.differenced[best.d];
+        size_t len = w.size();
+        size_t total = len + static_cast<size_t>(horizon);
+
+        // Residuals of the fitted model, then the recursion run on with future shocks of zero
+        std::vector<double> extended(w);
+        extended.resize(total, 0.0);
+        std::vector<double> residuals(total, 0.0);
+        ArmaObjective objective{w.data(), len, best.p, best.q, residuals.data()};
+        objective(best.params.data());
+        for (size_t t = len; t < total; ++t) {
+            double predicted = best.params[0];
+            for (int i = 1; i <= best.p; ++i) {
+                predicted += best.params[i] * extended[t - i];
+            }
+            for (int j = 1; j <= best.q; ++j) {
+                predicted += best.params[best.p + j] * residuals[t - j];
+            }
+            extended[t] = predicted;
+        }
+
+        // Undo the differencing and add the seasonal means back
+        const std::vector<double>& x = work.differenced[0];
+        size_t n = x.size();
+        double level = x.back();
+        for (int h = 1; h <= horizon; ++h) {
+            double step = extended[len + static_cast<size_t>(h) - 1];
+            level = (best.d == 0) ? step : level + step;
+            size_t slot = (n - 1 + static_cast<size_t>(h)) % work.seasonMeans.size();
+            result.forecast.push_back(level + work.seasonMeans[slot]);
+        }
+
+        std::ostringstream name;
+        name << "ARIMA(" << best.p << "," << best.d << "," << best.q << ")";
+        if (work.season > 1) {
+            name << " m=" << work.season;
+        }
+        result.valid = true;
+        result.method = Forecaster::Method::ARIMA;
+        result.model = name.str();
+        result.rmse = std::sqrt(best.sse / static_cast<double>(best.count));
+        result.aic = best.aic;
+        return result;
+    }
+
+    void prepare(SeriesWork& work, const Forecaster::Span& series, int seasonLength, Forecaster::Method method)
+    {
+        work.values = series;
+        const double* values = series.values;
+        size_t n = series.count;
+        int m = std::max(seasonLength, 1);
+        // Seasonal terms need two full seasons to initialise plus data to fit
+        work.season = (m > 1 && n >= 2 * static_cast<size_t>(m) + 2) ? m : 1;
+        size_t season = static_cast<size_t>(work.season);
+
+        if (method != Forecaster::Method::ARIMA) {
+            work.holtWinters.resize(sizeof(ALPHAS) / sizeof(ALPHAS[0]));
+        }
+        if (method == Forecaster::Method::HoltWinters) {
+            return;
+        }
+
+        work.seasonMeans.assign(season, 0.0);
+        if (season > 1) {
+            std::vector<size_t> counts(season, 0);
+            for (size_t t = 0; t < n; ++t) {
+                work.seasonMeans[t % season] += values[t];
+                ++counts[t % season];
+            }
+            for (size_t s = 0; s < season; ++s) {
+                work.seasonMeans[s] /= static_cast<double>(counts[s]);
+            }
+        }
+        std::vector<double>& x = work.differenced[0];
+        x.resize(n);
+        for (size_t t = 0; t < n; ++t) {
+            x[t] = values[t] - work.seasonMeans[t % season];
+        }
+        // d is fixed before the search: CSS fits of different d see different data (levels vs
+        // differences, of different lengths), so their AICs cannot rank each other
+        int& d = work.difference;
+        while (d < MAX_DIFF && work.differenced[d].size() > 2 && kpssStatistic(work.differenced[d]) > KPSS_CRITICAL_VALUE) {
+            const std::vector<double>& previous = work.differenced[d];
+            for (size_t t = 1; t < previous.size(); ++t) {
+                work.differenced[d + 1].push_back(previous[t] - previous[t - 1]);
+            }
+            ++d;
+        }
+        for (int p = 0; p <= MAX_AR; ++p) {
+            for (int q = 0; q <= MAX_MA; ++q) {
+                ArimaCandidate candidate;
+                candidate.p = p;
+                candidate.d = d;
+                candidate.q = q;
+                work.arima.push_back(candidate);
+            }
+        }
+    }
+}
+
+Forecaster::Result::Result()
+    : valid(false), method(Method::HoltWinters), rmse(0.0), aic(0.0) {}
+
+int Forecaster::seasonLength(WeatherRollup::Granularity granularity) {
+    switch (granularity) {
+        case WeatherRollup::Granularity::Day:
+            return 365;
+        case WeatherRollup::Granularity::Week:
+            return 52;
+        case WeatherRollup::Granularity::Month:
+            return 12;
+        default:
+            return 1;
+    }
+}
+
+// Function to lay (period, value) pairs out on consecutive periods
+std::vector<double> Forecaster::fillGaps(const std::vector<std::pair<int, double>>& points) {
+    std::vector<double> values;
+    if (points.empty()) {
+        return values;
+    }
+    values.reserve(static_cast<size_t>(points.back().first - points.front().first + 1));
+    values.push_back(points.front().second);
+    for (size_t i = 1; i < points.size(); ++i) {
+        int gap = points[i].first - points[i - 1].first;
+        for (int step = 1; step < gap; ++step) {
+            double fraction = static_cast<double>(step) / gap;
+            values.push_back(points[i - 1].second + fraction * (points[i].second - points[i - 1].second));
+        }
+        values.push_back(points[i].second);
+    }
+    return values;
+}
+
+// Function to fit every series on the pool and forecast each one
+std::vector<Forecaster::Result> Forecaster::forecastAll(const std::vector<std::vector<double>>& series, int seasonLength,
+                                                        Method method, int horizon, ThreadPool& pool) {
+    std::vector<Span> spans;
+    spans.reserve(series.size());
+    for (const std::vector<double>& values : series) {
+        spans.push_back(Span{values.data(), values.size()});
+    }
+    return forecastAll(spans, seasonLength, method, horizon, pool);
+}
+
+std::vector<Forecaster::Result> Forecaster::forecastAll(const std::vector<Span>& series, int seasonLength,
+                                                        Method method, int horizon, ThreadPool& pool) {
+    std::vector<Result> results(series.size());
+    if (horizon <= 0) {
+        return results;
+    }
+
+    // Candidate slots are sized before any task starts, so tasks never touch shared containers
+    std::vector<SeriesWork> work(series.size());
+    for (size_t s = 0; s < series.size(); ++s) {
+        if (series[s].count >= 3) {
+            prepare(work[s], series[s], seasonLength, method);
+        }
+    }
+    // This call's own batch: concurrent callers on the same pool do not wait for each other
+    ThreadPool::Batch batch;
+    for (SeriesWork& item : work) {
+        SeriesWork* current = &item;
+        for (size_t a = 0; a < item.holtWinters.size(); ++a) {
+            pool.submit(batch, [current, a] { fitHoltWintersRow(*current, ALPHAS[a], current->holtWinters[a]); });
+        }
+        for (size_t o = 0; o < item.arima.size(); ++o) {
+            pool.submit(batch, [current, o] { fitArimaOrder(*current, current->arima[o]); });
+        }
+    }
+    pool.wait(batch);
+
+    for (size_t s = 0; s < work.size(); ++s) {
+        const SeriesWork& item = work[s];
+        Result holtWintersFit;
+        Result arimaFit;
+        if (!item.holtWinters.empty()) {
+            const HoltWintersCandidate* best = &item.holtWinters[0];
+            for (const HoltWintersCandidate& candidate : item.holtWinters) {
+                if (candidate.sse < best->sse) best = &candidate;
+            }
+            if (best->count > 0) {
+                holtWintersFit = holtWintersResult(item, *best, horizon);
+            }
+        }
+        const ArimaCandidate* bestOrder = nullptr;
+        for (const ArimaCandidate& candidate : item.arima) {
+            if (candidate.valid && (bestOrder == nullptr || candidate.aic < bestOrder->aic)) {
+                bestOrder = &candidate;
+            }
+        }
+        if (bestOrder != nullptr) {
+            arimaFit = arimaResult(item, *bestOrder, horizon);
+        }
+
+        // The two models skip a different number of leading points, so their AICs are
+        // compared as an approximation
+        if (!arimaFit.valid || (holtWintersFit.valid && holtWintersFit.aic <= arimaFit.aic)) {
+            results[s] = holtWintersFit;
+        } else {
+            results[s] = arimaFit;
+        }
+    }
+    return results;
+}
+
+Forecaster::Result Forecaster::forecast(const std::vector<double>& series, int seasonLength, Method method, int horizon,
+                                        ThreadPool& pool) {
+    return forecastAll(std::vector<std::vector<double>>(1, series), seasonLength, method, horizon, pool).front();
+}
+
+const char* Forecaster::methodName(Method method) {
+    switch (method) {
+        case Method::HoltWinters:
+            return "Holt-Winters";
+        case Method::ARIMA:
+            return "ARIMA";
+        default:
+            return "Best of Holt-Winters and ARIMA";
+    }
+}
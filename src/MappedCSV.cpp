@@ -0,0 +1,102 @@
+#include "MappedCSV.h"
+#include "CSVScanner.h"
+#include <cstring>
+
+// ─────────────────────────────────────────────
+// CSVRow
+// ─────────────────────────────────────────────
+CSVRow::CSVRow(std::string_view line_, char delimiter_)
+    : line(line_), delimiter(delimiter_) {}
+
+size_t CSVRow::size() const {
+    if (line.empty()) {
+        return 0;
+    }
+    size_t count = 1;
+    for (char c : line) {
+        if (c == delimiter) {
+            ++count;
+        }
+    }
+    // A trailing delimiter does not start a new field
+    if (line.back() == delimiter) {
+        --count;
+    }
+    return count;
+}
+
+std::string_view CSVRow::operator[](size_t index) const {
+    size_t start = 0;
+    // Skip over the preceding fields
+    for (size_t i = 0; i < index; ++i) {
+        size_t pos = line.find(delimiter, start);
+        if (pos == std::string_view::npos) {
+            return std::string_view();
+        }
+        start = pos + 1;
+    }
+    size_t end = line.find(delimiter, start);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+    return line.substr(start, end - start);
+}
+
+void CSVRow::split(std::vector<std::string_view>& fields) const {
+    CSVScanner::splitLine(line.data(), line.size(), delimiter, fields);
+}
+
+// ─────────────────────────────────────────────
+// MappedCSV
+// ─────────────────────────────────────────────
+MappedCSV::MappedCSV() {}
+
+// Function to map a CSV file into memory and index its lines
+bool MappedCSV::open(const std::string& filename) {
+    close();
+    if (!file.open(filename)) {
+        return false;
+    }
+    indexLines();
+    return true;
+}
+
+void MappedCSV::close() {
+    file.close();
+    lineStarts.clear();
+}
+
+// Record the start offset of every line (one memchr per line)
+void MappedCSV::indexLines() {
+    lineStarts.clear();
+    const char* data = file.data();
+    size_t length = file.size();
+    if (length == 0) {
+        return;
+    }
+
+    size_t pos = 0;
+    while (pos < length) {
+        lineStarts.push_back(pos);
+        const void* nl = std::memchr(data + pos, '\n', length - pos);
+        if (nl == nullptr) {
+            break;
+        }
+        pos = static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+    }
+    lineStarts.push_back(length);
+}
+
+CSVRow MappedCSV::operator[](size_t row) const {
+    const char* data = file.data();
+    size_t start = lineStarts[row];
+    size_t end = lineStarts[row + 1];
+    // Strip the line terminator ("\n" or "\r\n")
+    if (end > start && data[end - 1] == '\n') {
+        --end;
+    }
+    if (end > start && data[end - 1] == '\r') {
+        --end;
+    }
+    return CSVRow(std::string_view(data + start, end - start));
+}
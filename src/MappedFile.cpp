@@ -0,0 +1,79 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile()
+    : bytes(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : bytes(nullptr), length(0), mapped(false) {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mapped = other.mapped;
+        length = other.length;
+        buffer = std::move(other.buffer);
+        bytes = mapped ? other.bytes : buffer.data();
+
+        other.bytes = nullptr;
+        other.length = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+// Function to map a file into memory
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* region = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region != MAP_FAILED) {
+            ::madvise(region, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(region);
+            length = static_cast<size_t>(st.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+
+    if (!mapped) {
+        // Not mappable: fall back to reading it into memory
+        std::ifstream infile(filename, std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+        bytes = buffer.data();
+        length = buffer.size();
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped && bytes != nullptr) {
+        ::munmap(const_cast<char*>(bytes), length);
+    }
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
@@ -8,10 +8,20 @@
 #include <algorithm>
 #include <sstream>
 #include <map>
+#include <chrono>
+#include <atomic>
 
-#include "CSVReader.h"
+#include "Backtester.h"
 #include "CandlestickCalculator.h"
+#include "Downsampler.h"
+#include "Exporter.h"
 #include "Candlestick.h"
+#include "Parallel.h"
+#include "QueryServer.h"
+#include "SeasonalModel.h"
+#include "TextFrame.h"
+#include "TimeUtils.h"
+#include "WeatherCache.h"
 
 namespace {
     /** 
@@ -24,6 +34,73 @@ namespace {
      */
     const int Y_LABEL_WIDTH = 8;  
 
+    /**
+     * @brief Chart width when stdout is not a terminal and $COLUMNS is unset (e.g. a log pipe)
+     */
+    const size_t FALLBACK_WIDTH = 160;
+
+    /**
+     * @brief Say so below a chart that shows fewer points than its series has
+     */
+    void noteDownsampled(size_t total, size_t shown, const char* unit)
+    {
+        if (shown < total) {
+            std::cout << "Note: downsampled " << total << " → " << shown << " " << unit
+                      << " to fit the chart width (" << FALLBACK_WIDTH << " columns when piped without $COLUMNS)." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Most countries a batch may name and still load only their columns (~0.3 s for
+     *        four on 40 years, against ~1.5 s for a full load). Larger batches do the full
+     *        load, which also writes the cache that later runs map
+     */
+    const size_t MAX_PROJECTED_COUNTRIES = 4;
+
+    /**
+     * @brief Parse a window bound "YYYY-MM-DD[ HH:MM:SS]"; an end bound is
+     *        inclusive, so a bare date ends after that day and a time after that second
+     */
+    bool parseWindowBound(const std::string& text, bool isEnd, int64_t& epochSeconds)
+    {
+        if (!TimeUtils::parseDateTime(text, epochSeconds)) {
+            return false;
+        }
+        if (isEnd) {
+            epochSeconds += (text.size() <= 10) ? 86400 : 1;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Series-cache aggregate name for a data type: "mean", "max", "min" or "p<n>"
+     */
+    std::string aggregateKey(int dataType, double percentile)
+    {
+        if (dataType <= 3) {
+            return (dataType == 1) ? "mean" : (dataType == 2) ? "max" : "min";
+        }
+        std::ostringstream name;
+        name << "p" << percentile;
+        return name.str();
+    }
+
+    /**
+     * @brief Histogram title word for a data type: "Average", "Max", "Min", "Median" or "P<n>"
+     */
+    std::string dataTypeName(int dataType, double percentile)
+    {
+        if (dataType <= 3) {
+            return (dataType == 1) ? "Average" : (dataType == 2) ? "Max" : "Min";
+        }
+        if (dataType == 4) {
+            return "Median";
+        }
+        std::ostringstream name;
+        name << "P" << percentile;
+        return name.str();
+    }
+
     /**
      * @brief Utility function to return a string with fixed width
      */
@@ -39,13 +116,45 @@ namespace {
 // ─────────────────────────────────────────────
 // Constructor
 // ─────────────────────────────────────────────
-MerkelMain::MerkelMain()
+MerkelMain::MerkelMain(unsigned workerCount_, const std::string& dataFilename_, const std::vector<std::string>& countries_)
+    : workerCount(Parallel::workerCount(workerCount_)),
+      queryWorkers(workerCount),
+      dataFilename(dataFilename_),
+      forecastPool(workerCount)
 {
-    std::string filename = "../weather_data.csv";
-    csvData = CSVReader::readCSV(filename);
-    if (csvData.empty()) {
-        std::cerr << "Error: Failed to read CSV data from " << filename << std::endl;
+    // Warm starts map the binary cache; a missing or stale cache is rebuilt from the CSV,
+    // unless the session needs only a few countries: then just their columns are parsed
+    bool projected = !countries_.empty() && countries_.size() <= MAX_PROJECTED_COUNTRIES &&
+                     !WeatherCache::isFresh(WeatherCache::cachePathFor(dataFilename), dataFilename);
+    bool loaded = false;
+    if (projected) {
+        std::vector<std::string> projection;
+        for (const std::string& country : countries_) {
+            projection.push_back(country + "_" + WeatherSchema::TEMPERATURE);
+        }
+        loaded = weatherTable.loadProjected(dataFilename, projection, workerCount);
+    } else {
+        loaded = WeatherCache::loadOrBuild(dataFilename, weatherTable, workerCount);
+    }
+    if (!loaded) {
+        std::cerr << "Error: Failed to read CSV data from " << dataFilename << std::endl;
+        return;
+    }
+
+    // Pre-aggregate every temperature column (or the projected ones) so queries at any
+    // granularity skip the rows
+    const WeatherSchema& schema = weatherTable.schema();
+    for (const std::string& country : schema.countries()) {
+        if (projected && std::find(countries_.begin(), countries_.end(), country) == countries_.end()) {
+            continue;
+        }
+        int column = schema.columnIndex(country, WeatherSchema::TEMPERATURE);
+        if (column != -1) {
+            temperatureColumns.push_back(static_cast<size_t>(column));
+        }
     }
+    weatherRollup.build(weatherTable, temperatureColumns, workerCount);
+    windowIndex.attach(weatherTable);
 }
 
 // ─────────────────────────────────────────────
@@ -79,6 +188,15 @@ void MerkelMain::printMenu()
     std::cout << "3: Plot Candlestick Data (Compute behind the scenes)\n";
     std::cout << "4: Show Yearly Temperature Histogram\n";
     std::cout << "5: Predict Future Temperature (Linear Regression)\n";
+    std::cout << "6: Compute Candlestick Data for All Countries\n";
+    std::cout << "7: Query Time Window (OHLC, Min, Max, Mean)\n";
+    std::cout << "8: Refresh Data (Load Rows Appended to the CSV)\n";
+    std::cout << "9: Forecast All Countries (Linear Regression)\n";
+    std::cout << "10: Seasonal Forecast (Hourly Trend + Annual/Daily Cycles)\n";
+    std::cout << "11: Forecast with Holt-Winters / ARIMA\n";
+    std::cout << "12: Forecast Report for All Countries (Holt-Winters / ARIMA)\n";
+    std::cout << "13: Backtest Forecast Models (Rolling-Origin MAE/RMSE)\n";
+    std::cout << "14: Export Data (CSV, JSON Lines, Binary)\n";
     std::cout << "0: Exit\n";
     std::cout << "==============\n";
 }
@@ -102,13 +220,40 @@ void MerkelMain::printHelp()
     std::cout << "   - This provides a visual representation of temperature trends over the years.\n\n";
     
     std::cout << "4: Show Yearly Temperature Histogram - Display a vertical histogram of yearly temperatures.\n";
-    std::cout << "   - You can choose to view Average, Maximum, or Minimum temperatures.\n";
+    std::cout << "   - You can choose to view Average, Maximum, or Minimum temperatures, the Median, or any percentile.\n";
     std::cout << "   - This helps in understanding the distribution and range of temperatures over the years.\n\n";
     
     std::cout << "5: Predict Future Temperature (Linear Regression) - Perform linear regression analysis to predict future temperatures.\n";
     std::cout << "   - Based on historical data, the application will forecast temperatures for the specified number of future years.\n";
     std::cout << "   - The prediction is visualized on a text-based plot, differentiating past data from predicted values.\n\n";
     
+    std::cout << "6: Compute Candlestick Data for All Countries - Compute yearly candlesticks for every country in one pass.\n";
+    std::cout << "   - Prints a per-country summary: years covered, first and last yearly average, and the extremes.\n\n";
+
+    std::cout << "7: Query Time Window - Open, high, low, close and mean temperature for a country between two dates.\n";
+    std::cout << "   - Dates are entered as YYYY-MM-DD, optionally followed by HH:MM:SS; both ends are inclusive.\n\n";
+
+    std::cout << "8: Refresh Data - Read only the rows appended to the CSV since start-up (or the last refresh).\n";
+    std::cout << "   - Aggregates are updated for the new periods only; cached results are discarded.\n\n";
+
+    std::cout << "9: Forecast All Countries - Fit a linear trend for every country at once and print the forecasts.\n";
+    std::cout << "   - Shows each country's slope, the next period's forecast and the forecast N periods ahead.\n\n";
+
+    std::cout << "10: Seasonal Forecast - Fit a trend plus yearly and daily temperature cycles to every hourly reading.\n";
+    std::cout << "   - Forecasts follow the seasons, so monthly or daily forecasts are not a straight line.\n\n";
+
+    std::cout << "11: Forecast with Holt-Winters / ARIMA - Fit exponential smoothing and ARIMA(p,d,q) models to a country's period means.\n";
+    std::cout << "   - Parameters and model orders are searched automatically; choose one method or let the lower AIC decide.\n\n";
+
+    std::cout << "12: Forecast Report for All Countries - Fit the same models to every country at once.\n";
+    std::cout << "   - Prints each country's chosen model, its in-sample error and the forecast N periods ahead.\n\n";
+
+    std::cout << "13: Backtest Forecast Models - Replay forecasts from past cutoffs, one year apart, for every country.\n";
+    std::cout << "   - Each model is trained on the data before a cutoff and scored (MAE/RMSE) on the periods that followed.\n\n";
+
+    std::cout << "14: Export Data - Write candlesticks, period values, forecasts or every hourly reading to a file.\n";
+    std::cout << "   - Formats: csv, jsonl (one JSON object per line) or bin (compact columnar binary); \"all\" exports every country.\n\n";
+
     std::cout << "0: Exit - Close the application.\n\n";
     
     std::cout << "Instructions:\n";
@@ -121,7 +266,12 @@ void MerkelMain::printHelp()
     std::cout << "1. To compute candlestick data, select option 2 and enter the desired country code when prompted.\n";
     std::cout << "2. To visualize the data, select option 3 to see the candlestick chart.\n";
     std::cout << "3. For a statistical overview, select option 4 to view the temperature histogram.\n";
-    std::cout << "4. To forecast future temperatures, select option 5 and specify the number of years you wish to predict.\n";
+    std::cout << "4. To forecast future temperatures, select option 5 and specify the number of years you wish to predict.\n\n";
+
+    std::cout << "Series cache: " << seriesCache.entries() << " entries, "
+              << seriesCache.bytes() / 1024 << " / " << seriesCache.capacity() / 1024 << " KiB, "
+              << seriesCache.hits() << " hits, " << seriesCache.misses() << " misses, "
+              << seriesCache.evictions() << " evictions\n";
     
     std::cout << "========================================\n";
 }
@@ -180,6 +330,42 @@ void MerkelMain::processUserOption(int userOption)
             // (5) Predict Future Temperature (Linear Regression)
             predictFutureTemperature();
             break;
+        case 6:
+            // (6) Compute Candlestick Data for All Countries
+            computeAllCountriesSummary();
+            break;
+        case 7:
+            // (7) OHLC, Min, Max and Mean for a Time Window
+            queryTimeWindow();
+            break;
+        case 8:
+            // (8) Load Appended Rows
+            refreshData();
+            break;
+        case 9:
+            // (9) Linear Trend Forecast for Every Country
+            forecastAllCountries();
+            break;
+        case 10:
+            // (10) Seasonal Model on the Hourly Readings
+            predictSeasonalTemperature();
+            break;
+        case 11:
+            // (11) Holt-Winters / ARIMA Forecast
+            forecastWithModels();
+            break;
+        case 12:
+            // (12) Holt-Winters / ARIMA Forecast for Every Country
+            forecastReportAllCountries();
+            break;
+        case 13:
+            // (13) Rolling-Origin Backtest of the Forecast Models
+            backtestForecastModels();
+            break;
+        case 14:
+            // (14) Export Results to a File
+            exportData();
+            break;
         default:
             std::cout << "Invalid choice. Choose a valid option." << std::endl;
             break;
@@ -200,15 +386,58 @@ std::string MerkelMain::getCountryCodeFromUser()
     return countryCode;
 }
 
+// ─────────────────────────────────────────────
+// Get Granularity (Year, Month, Week, Day) from User
+// ─────────────────────────────────────────────
+WeatherRollup::Granularity MerkelMain::getGranularityFromUser()
+{
+    std::cout << "Granularity (year, month, week, day) [year]: ";
+    std::string line;
+    std::getline(std::cin, line);
+    WeatherRollup::Granularity granularity = WeatherRollup::Granularity::Year;
+    if (!line.empty() && !WeatherRollup::parseGranularity(line, granularity)) {
+        std::cout << "Unknown granularity \"" << line << "\", using year." << std::endl;
+    }
+    return granularity;
+}
+
+// ─────────────────────────────────────────────
+// Get Forecast Method from User
+// ─────────────────────────────────────────────
+bool MerkelMain::getForecastMethodFromUser(Forecaster::Method& method)
+{
+    std::cout << "1: Holt-Winters (exponential smoothing)\n"
+              << "2: ARIMA(p,d,q)\n"
+              << "3: Best of both by AIC [default]\n"
+              << ">> ";
+    std::string line;
+    std::getline(std::cin, line);
+    if (line.empty() || line == "3") {
+        method = Forecaster::Method::Best;
+    } else if (line == "1") {
+        method = Forecaster::Method::HoltWinters;
+    } else if (line == "2") {
+        method = Forecaster::Method::ARIMA;
+    } else {
+        std::cerr << "Invalid forecast method.\n";
+        return false;
+    }
+    return true;
+}
+
 // ─────────────────────────────────────────────
 // Get Data Type (Average, Max, Min) from User
 // ─────────────────────────────────────────────
-int MerkelMain::getDataTypeFromUser()
+int MerkelMain::getDataTypeFromUser(double& percentile)
 {
     // Select Data Type
     std::cout << "1: Average Temperature\n"
               << "2: Max Temperature\n"
               << "3: Min Temperature\n"
+              << "4: Median Temperature\n"
+              << "5: 10th Percentile\n"
+              << "6: 90th Percentile\n"
+              << "7: Other Percentile\n"
               << ">> ";
     std::string line;
     std::getline(std::cin, line);
@@ -218,20 +447,105 @@ int MerkelMain::getDataTypeFromUser()
     } catch(...) {
         dataType = 1; // Default
     }
-    if (dataType < 1 || dataType > 3) dataType = 1;
+    if (dataType < 1 || dataType > 7) dataType = 1;
+
+    percentile = (dataType == 5) ? 10.0 : (dataType == 6) ? 90.0 : 50.0;
+    if (dataType == 7) {
+        std::cout << "Percentile (0-100): ";
+        std::getline(std::cin, line);
+        try {
+            percentile = std::stod(line);
+        } catch(...) {
+            percentile = -1.0;
+        }
+        if (!(percentile >= 0.0 && percentile <= 100.0)) {
+            std::cout << "Invalid percentile, using the median.\n";
+            percentile = 50.0;
+        }
+    }
     return dataType;
 }
 
 // ─────────────────────────────────────────────
 // Compute Candlestick Data from CSV for a Given Country
 // ─────────────────────────────────────────────
-std::vector<Candlestick> MerkelMain::computeCandlestickDataForCountry(const std::string& countryCode)
+std::vector<Candlestick> MerkelMain::computeCandlestickDataForCountry(const std::string& countryCode,
+                                                                     WeatherRollup::Granularity granularity)
 {
-    if (csvData.empty()) {
+    if (weatherTable.empty()) {
         std::cerr << "Error: No CSV data available to compute candlestick data." << std::endl;
         return {};
     }
-    return CandlestickCalculator::computeCandlestickData(csvData, countryCode);
+
+    SeriesCache::Key key(countryCode, WeatherSchema::TEMPERATURE, granularity, "ohlc");
+    std::shared_ptr<const SeriesCache::Series> cached = seriesCache.find(key);
+    if (cached) {
+        return cached->candles;
+    }
+
+    SeriesCache::Series series;
+    series.candles = CandlestickCalculator::computeCandlestickData(weatherTable, weatherRollup, countryCode, granularity);
+    if (series.candles.empty()) {
+        return {}; // Errors are not cached
+    }
+    return seriesCache.store(key, std::move(series))->candles;
+}
+
+// ─────────────────────────────────────────────
+// Read (Period, Value) Pairs from the Rollup
+// ─────────────────────────────────────────────
+std::vector<std::pair<int, double>> MerkelMain::collectPeriodValues(const std::string& countryCode, int column,
+                                                                    WeatherRollup::Granularity granularity, int dataType,
+                                                                    double percentile)
+{
+    SeriesCache::Key key(countryCode, WeatherSchema::TEMPERATURE, granularity, aggregateKey(dataType, percentile));
+    std::shared_ptr<const SeriesCache::Series> cached = seriesCache.find(key);
+    if (cached) {
+        return cached->points;
+    }
+
+    SeriesCache::Series series;
+    std::vector<std::pair<int, double>>& periodData = series.points;
+    int64_t firstPeriod = weatherRollup.firstPeriod(granularity);
+
+    // Percentiles: one bounded-size sketch per period, streamed from the rows
+    if (dataType >= 4) {
+        std::vector<TDigest> sketches = weatherRollup.sketches(weatherTable, static_cast<size_t>(column), granularity, queryWorkers);
+        for (size_t i = 0; i < sketches.size(); ++i) {
+            if (!sketches[i].empty()) {
+                periodData.emplace_back(static_cast<int>(firstPeriod + static_cast<int64_t>(i)),
+                                        sketches[i].quantile(percentile / 100.0));
+            }
+        }
+        return seriesCache.store(key, std::move(series))->points;
+    }
+
+    const WeatherRollup::Bucket* buckets = weatherRollup.buckets(granularity, static_cast<size_t>(column));
+    if (buckets == nullptr) {
+        return periodData;
+    }
+
+    for (size_t i = 0; i < weatherRollup.bucketCount(granularity); ++i) {
+        const WeatherRollup::Bucket& bucket = buckets[i];
+        if (bucket.count == 0) {
+            continue; // No data in this period
+        }
+        double value = (dataType == 1) ? bucket.mean() : (dataType == 2) ? bucket.max : bucket.min;
+        periodData.emplace_back(static_cast<int>(firstPeriod + static_cast<int64_t>(i)), value);
+    }
+    return seriesCache.store(key, std::move(series))->points;
+}
+
+// ─────────────────────────────────────────────
+// Linear Trends of Every Temperature Column at a Granularity
+// ─────────────────────────────────────────────
+const RegressionEngine& MerkelMain::regressionFor(WeatherRollup::Granularity granularity)
+{
+    RegressionEngine& engine = regressions[static_cast<size_t>(granularity)];
+    if (engine.empty()) {
+        engine.build(weatherRollup, temperatureColumns, granularity, workerCount);
+    }
+    return engine;
 }
 
 // ─────────────────────────────────────────────
@@ -244,7 +558,9 @@ void MerkelMain::computeAndDisplayCandlestickData()
         return; // Input error
     }
 
-    std::vector<Candlestick> candles = computeCandlestickDataForCountry(countryCode);
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+
+    std::vector<Candlestick> candles = computeCandlestickDataForCountry(countryCode, granularity);
     if (candles.empty()) {
         std::cerr << "No candlestick data computed. "
                   << "Check if the country code is correct and data is available.\n";
@@ -258,8 +574,7 @@ void MerkelMain::computeAndDisplayCandlestickData()
 
     int count = 0;
     for (const auto& candle : candles) {
-        std::string year = candle.date.substr(0, 4);
-        std::cout << year << "\t"
+        std::cout << candle.label() << "\t"
                   << std::fixed << std::setprecision(3) << candle.open << "\t"
                   << candle.high << "\t"
                   << candle.low << "\t"
@@ -269,9 +584,18 @@ void MerkelMain::computeAndDisplayCandlestickData()
     }
 
     if (count < 40) {
-        std::cout << "Warning: Only " << count << " years of data available for country code "
+        std::cout << "Warning: Only " << count << " " << WeatherRollup::granularityName(granularity)
+                  << "s of data available for country code "
                   << countryCode << "." << std::endl;
     }
+
+    // Report cells that were stored as NaN while loading
+    int column = weatherTable.schema().columnIndex(countryCode, WeatherSchema::TEMPERATURE);
+    const WeatherTable::ColumnStats& stats = weatherTable.columnStats(column);
+    if (stats.missing > 0 || stats.invalid > 0) {
+        std::cout << "Note: " << stats.missing << " empty and " << stats.invalid
+                  << " invalid cells were skipped for " << countryCode << "." << std::endl;
+    }
 }
 
 // ─────────────────────────────────────────────
@@ -284,7 +608,9 @@ void MerkelMain::computeCandlestickAndPlot()
         return;
     }
 
-    std::vector<Candlestick> candles = computeCandlestickDataForCountry(countryCode);
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+
+    std::vector<Candlestick> candles = computeCandlestickDataForCountry(countryCode, granularity);
     if (candles.empty()) {
         std::cerr << "No candlestick data computed. "
                   << "Check if the country code is correct and data is available.\n";
@@ -297,16 +623,213 @@ void MerkelMain::computeCandlestickAndPlot()
     plotCandlestickData(lastComputedCandles, 40);
 }
 
+// ─────────────────────────────────────────────
+// (Menu 6) Compute Candlestick Data for All Countries
+// ─────────────────────────────────────────────
+void MerkelMain::computeAllCountriesSummary()
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available to compute candlestick data." << std::endl;
+        return;
+    }
+
+    // Served from the cache only if every country's series is there; otherwise one scan refills all
+    const WeatherSchema& schema = weatherTable.schema();
+    std::map<std::string, std::vector<Candlestick>> candlesByCountry;
+    bool allCached = true;
+    for (const std::string& country : schema.countries()) {
+        if (schema.columnIndex(country, WeatherSchema::TEMPERATURE) == -1) {
+            continue;
+        }
+        std::shared_ptr<const SeriesCache::Series> cached =
+            seriesCache.find(SeriesCache::Key(country, WeatherSchema::TEMPERATURE, WeatherRollup::Granularity::Year, "ohlc-scan"));
+        if (!cached) {
+            allCached = false;
+            break;
+        }
+        if (!cached->candles.empty()) {
+            candlesByCountry[country] = cached->candles;
+        }
+    }
+
+    if (!allCached) {
+        candlesByCountry = CandlestickCalculator::computeAllCandlestickData(weatherTable, workerCount);
+        for (const std::string& country : schema.countries()) {
+            if (schema.columnIndex(country, WeatherSchema::TEMPERATURE) == -1) {
+                continue;
+            }
+            // Countries without readings are stored empty so the next call can still hit
+            SeriesCache::Series series;
+            auto found = candlesByCountry.find(country);
+            if (found != candlesByCountry.end()) {
+                series.candles = found->second;
+            }
+            seriesCache.store(SeriesCache::Key(country, WeatherSchema::TEMPERATURE, WeatherRollup::Granularity::Year, "ohlc-scan"),
+                              std::move(series));
+        }
+    }
+    if (candlesByCountry.empty()) {
+        std::cerr << "No candlestick data computed. Check that the data has temperature columns.\n";
+        return;
+    }
+
+    std::cout << "Candle summary : " << candlesByCountry.size() << " countries" << std::endl;
+    std::cout << "Country\tYears\tFirst\tLast\tFirstAvg\tLastAvg\tLow\tHigh\n";
+    for (const auto& entry : candlesByCountry) {
+        const std::vector<Candlestick>& candles = entry.second;
+        double low = candles.front().low;
+        double high = candles.front().high;
+        for (const auto& candle : candles) {
+            low = std::min(low, candle.low);
+            high = std::max(high, candle.high);
+        }
+        std::cout << entry.first << "\t"
+                  << candles.size() << "\t"
+                  << candles.front().period << "\t"
+                  << candles.back().period << "\t"
+                  << std::fixed << std::setprecision(3) << candles.front().close << "\t\t"
+                  << candles.back().close << "\t"
+                  << low << "\t"
+                  << high << std::endl;
+    }
+}
+
+// ─────────────────────────────────────────────
+// (Menu 7) Query an Arbitrary Time Window
+// ─────────────────────────────────────────────
+void MerkelMain::queryTimeWindow()
+{
+    std::string countryCode = getCountryCodeFromUser();
+    if (countryCode.empty()) {
+        return; // Input error
+    }
+    int column = weatherTable.schema().columnIndex(countryCode, WeatherSchema::TEMPERATURE);
+    if (column == -1) {
+        std::cerr << "Error: Country code " << countryCode << " not found in headers." << std::endl;
+        return;
+    }
+
+    std::string startText;
+    std::string endText;
+    std::cout << "Window start (YYYY-MM-DD[ HH:MM:SS]): ";
+    std::getline(std::cin, startText);
+    std::cout << "Window end, inclusive (YYYY-MM-DD[ HH:MM:SS]): ";
+    std::getline(std::cin, endText);
+
+    int64_t from = 0;
+    int64_t to = 0;
+    if (!parseWindowBound(startText, false, from) || !parseWindowBound(endText, true, to)) {
+        std::cerr << "Error: Dates must be given as YYYY-MM-DD or YYYY-MM-DD HH:MM:SS.\n";
+        return;
+    }
+    if (from >= to) {
+        std::cerr << "Error: The window end must not be before its start.\n";
+        return;
+    }
+
+    RangeIndex::Stats stats = windowStats(countryCode, column, from, to);
+    if (stats.count == 0) {
+        std::cout << "No temperature readings for " << countryCode << " in this window." << std::endl;
+        return;
+    }
+
+    std::cout << "Window : " << countryCode << " " << startText << " .. " << endText
+              << " (" << stats.count << " readings)" << std::endl;
+    std::cout << "Open\tHigh\tLow\tClose\tMean\n";
+    std::cout << std::fixed << std::setprecision(3)
+              << stats.open << "\t"
+              << stats.high << "\t"
+              << stats.low << "\t"
+              << stats.close << "\t"
+              << stats.mean << std::endl;
+
+    std::cout << "Plot the hourly readings? (y/N): ";
+    std::string answer;
+    std::getline(std::cin, answer);
+    if (answer == "y" || answer == "Y") {
+        plotWindowReadings(column, from, to);
+    }
+}
+
+// ─────────────────────────────────────────────
+// Window Statistics of a Country, from the Cache or the Window Index
+// ─────────────────────────────────────────────
+RangeIndex::Stats MerkelMain::windowStats(const std::string& countryCode, int column, int64_t from, int64_t to)
+{
+    SeriesCache::Key key(countryCode, WeatherSchema::TEMPERATURE, WeatherRollup::Granularity::Day, "window", from, to);
+    std::shared_ptr<const SeriesCache::Series> cached = seriesCache.find(key);
+    if (!cached) {
+        SeriesCache::Series series;
+        series.window = windowIndex.query(static_cast<size_t>(column), from, to);
+        cached = seriesCache.store(key, std::move(series));
+    }
+    return cached->window;
+}
+
+// ─────────────────────────────────────────────
+// (Menu 7) Chart Every Reading of a Time Window
+// ─────────────────────────────────────────────
+void MerkelMain::plotWindowReadings(int column, int64_t from, int64_t to) const
+{
+    // Rows of the window by binary search on the sorted timestamps (all rows, filtered, otherwise)
+    const int64_t* timestamps = weatherTable.timestamps();
+    const double* values = weatherTable.column(static_cast<size_t>(column));
+    std::pair<size_t, size_t> rows(0, weatherTable.rowCount());
+    if (weatherTable.timestampsAscending()) {
+        rows = windowIndex.rowRange(from, to);
+    }
+
+    std::vector<double> x;
+    std::vector<double> y;
+    x.reserve(rows.second - rows.first);
+    y.reserve(rows.second - rows.first);
+    for (size_t row = rows.first; row < rows.second; ++row) {
+        if (timestamps[row] >= from && timestamps[row] < to && !std::isnan(values[row])) {
+            x.push_back(static_cast<double>(timestamps[row]));
+            y.push_back(values[row]);
+        }
+    }
+    if (x.size() < 2) {
+        std::cout << "Not enough readings to plot." << std::endl;
+        return;
+    }
+
+    // One chart column per point: LTTB keeps the readings that shape the curve
+    size_t width = TextFrame::terminalWidth(FALLBACK_WIDTH);
+    size_t budget = width > 8 + 3 * 4 ? (width - 8) / 3 : 4;
+    std::vector<size_t> kept = Downsampler::lttb(x.data(), y.data(), x.size(), budget);
+
+    // X-axis ticks show the day of the month of each kept reading
+    std::vector<std::pair<int, double>> points;
+    points.reserve(kept.size());
+    for (size_t index : kept) {
+        int64_t day = WeatherRollup::periodOf(WeatherRollup::Granularity::Day, static_cast<int64_t>(x[index]));
+        points.emplace_back(static_cast<int>(day), y[index]);
+    }
+    std::ostringstream title;
+    title << "Hourly Readings (" << x.size() << " points, " << kept.size() << " shown)";
+    plotPrediction(points, {}, WeatherRollup::Granularity::Day, title.str());
+}
+
 // ─────────────────────────────────────────────
 // (Menu 3) Plot Candlestick Data as Text
 // ─────────────────────────────────────────────
-void MerkelMain::plotCandlestickData(const std::vector<Candlestick>& candles, int maxDisplayCount)
+void MerkelMain::plotCandlestickData(const std::vector<Candlestick>& allCandles, int maxDisplayCount)
 {
-    if (candles.empty()) {
+    if (allCandles.empty()) {
         std::cout << "No data to plot." << std::endl;
         return;
     }
-    int displayCount = std::min(static_cast<int>(candles.size()), maxDisplayCount);
+
+    // Merge runs of candles down to at most maxDisplayCount columns, fewer on a narrow terminal
+    const size_t bodyColumn = 9; // Label (6) + " ┃ "
+    size_t fit = static_cast<size_t>(std::max(maxDisplayCount, 1));
+    size_t width = TextFrame::terminalWidth(FALLBACK_WIDTH);
+    if (width >= bodyColumn + COLUMN_WIDTH) {
+        fit = std::min(fit, (width - bodyColumn) / COLUMN_WIDTH);
+    }
+    std::vector<Candlestick> candles = Downsampler::candles(allCandles, fit);
+    int displayCount = static_cast<int>(candles.size());
 
     // Calculate minLow and maxHigh
     double minLow = std::numeric_limits<double>::max();
@@ -324,17 +847,19 @@ void MerkelMain::plotCandlestickData(const std::vector<Candlestick>& candles, in
     }
     double scale = static_cast<double>(chartHeight) / range;
 
+    // Rows chartHeight..0 of the chart, then the X-axis labels
+    TextFrame frame(bodyColumn + static_cast<size_t>(displayCount) * COLUMN_WIDTH, chartHeight + 2);
+
     // Main chart body (from top to bottom)
     for (int row = chartHeight; row >= 0; --row)
     {
-        // Y-axis label on the left
+        size_t line = static_cast<size_t>(chartHeight - row);
+
+        // Y-axis label on the left, right-aligned
         double actualValue = minLow + (row / scale);
         std::ostringstream yLabelSS;
-        yLabelSS << std::fixed << std::setprecision(1) << actualValue;
-        std::string yLabelStr = yLabelSS.str();
-
-        // Align the label to the right
-        std::cout << std::setw(6) << yLabelStr << " ┃ ";
+        yLabelSS << std::fixed << std::setprecision(1) << std::setw(6) << actualValue;
+        frame.text(line, 0, yLabelSS.str() + " ┃ ");
 
         // Plot each candlestick
         for (int i = 0; i < displayCount; ++i)
@@ -352,9 +877,8 @@ void MerkelMain::plotCandlestickData(const std::vector<Candlestick>& candles, in
             int boxTop    = std::max(scaledOpen, scaledClose);
             int boxBottom = std::min(scaledOpen, scaledClose);
 
-            // Outside candlestick drawing range
+            // Outside candlestick drawing range: the cells stay blank
             if (row > scaledHigh || row < scaledLow) {
-                std::cout << std::string(COLUMN_WIDTH, ' ');
                 continue;
             }
 
@@ -362,45 +886,40 @@ void MerkelMain::plotCandlestickData(const std::vector<Candlestick>& candles, in
                                ((row <= boxBottom) && (row >= scaledLow));
             bool isBoxRange  = (row <= boxTop && row >= boxBottom);
 
+            size_t cell = bodyColumn + static_cast<size_t>(i) * COLUMN_WIDTH + COLUMN_WIDTH / 2;
             if (row == scaledHigh) {
                 // Top of upper wick
-                std::cout << "  ^  ";
+                frame.put(line, cell, "^");
             }
             else if (row == scaledLow) {
                 // Bottom of lower wick
-                std::cout << "  v  ";
+                frame.put(line, cell, "v");
             }
             else if (isBoxRange) {
-                // Body of the candlestick
-                if (close >= open) { // Bullish
-                    std::cout << "\033[32m"; // Green color
-                } else {             // Bearish
-                    std::cout << "\033[31m"; // Red color
-                }
-                std::cout << "  █  ";
-                std::cout << "\033[0m"; // Reset color
+                // Body of the candlestick: green when bullish, red when bearish
+                frame.put(line, cell, "█", close >= open ? TextFrame::Color::Green : TextFrame::Color::Red);
             }
             else if (isWickRange) {
                 // Wick part
-                std::cout << "  │  ";
-            }
-            else {
-                std::cout << std::string(COLUMN_WIDTH, ' ');
+                frame.put(line, cell, "│");
             }
         }
-        std::cout << std::endl;
     }
 
-    // X-axis labels (years)
-    std::cout << std::string(6, ' ') << "  ";
+    // X-axis labels (years; finer periods show their month or day number)
+    size_t axisColumn = 8;
     for (int i = 0; i < displayCount; ++i) {
-        std::string yearStr = "----";
-        if (candles[i].date.size() >= 4) {
-            yearStr = candles[i].date.substr(0, 4);
+        int tick = WeatherRollup::periodTick(candles[i].granularity, candles[i].period);
+        std::ostringstream tickStream;
+        if (candles[i].granularity == WeatherRollup::Granularity::Year) {
+            tickStream << tick;
+        } else {
+            tickStream << std::setw(2) << std::setfill('0') << tick;
         }
-        std::cout << fixedWidth(yearStr, COLUMN_WIDTH);
+        axisColumn = frame.text(chartHeight + 1, axisColumn, fixedWidth(tickStream.str(), COLUMN_WIDTH));
     }
-    std::cout << std::endl;
+    frame.print();
+    noteDownsampled(allCandles.size(), candles.size(), "candles");
 }
 
 // ─────────────────────────────────────────────
@@ -415,126 +934,67 @@ void MerkelMain::showYearlyHistogram()
     }
 
     // (2) Select Data Type
-    int dataType = getDataTypeFromUser(); 
-    // 1=Average, 2=Max, 3=Min
+    double percentile = 50.0;
+    int dataType = getDataTypeFromUser(percentile); 
+    // 1=Average, 2=Max, 3=Min, 4..7=Percentile
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
 
     // (3) Check if CSV Data Exists
-    if (csvData.empty()) {
+    if (weatherTable.empty()) {
         std::cout << "CSV data is empty.\n";
         return;
     }
 
-    // Get header row
-    const std::vector<std::string>& header = csvData[0];
-    std::string targetColumn = countryCode + "_temperature";
-    int targetIndex = -1;
-
-    // Find target column in header
-    for (size_t i = 0; i < header.size(); ++i) {
-        if (header[i] == targetColumn) {
-            targetIndex = static_cast<int>(i);
-            break;
-        }
-    }
+    // Find target column through the schema
+    const WeatherSchema& schema = weatherTable.schema();
+    int targetIndex = schema.columnIndex(countryCode, WeatherSchema::TEMPERATURE);
 
     if (targetIndex == -1) {
         std::cout << "The specified country code \"" << countryCode << "\" was not found in the headers.\n";
         std::cout << "Available country codes are as follows:\n";
-        for (size_t i = 1; i < header.size(); ++i) { // Skip first column (timestamp)
-            // Extract country code from "AT_temperature"
-            size_t pos = header[i].find("_temperature");
-            if (pos != std::string::npos) {
-                std::string code = header[i].substr(0, pos);
+        for (const std::string& code : schema.countries()) {
+            if (schema.columnIndex(code, WeatherSchema::TEMPERATURE) != -1) {
                 std::cout << "- " << code << "\n";
             }
         }
         return;
     }
 
-    // Map to store yearly temperature data
-    std::map<int, std::vector<double>> yearToTemps;
-
-    // Process data rows
-    for (size_t i = 1; i < csvData.size(); ++i) { // Skip header
-        const std::vector<std::string>& row = csvData[i];
-        if (static_cast<int>(row.size()) <= targetIndex) {
-            continue; // Skip if target column does not exist
-        }
-
-        // Extract year from timestamp
-        std::string timestamp = row[0];
-        if (timestamp.size() < 4) {
-            continue; // Invalid timestamp
-        }
-        int year = 0;
-        try {
-            year = std::stoi(timestamp.substr(0, 4));
-        } catch (...) {
-            continue; // Invalid year
-        }
-
-        // Get temperature data
-        double temperature = 0.0;
-        try {
-            temperature = std::stod(row[targetIndex]);
-        } catch (...) {
-            continue; // Invalid temperature data
-        }
-
-        // Update yearly data
-        yearToTemps[year].push_back(temperature);
-    }
-
-    // (4) Aggregate yearly data as "Average or Max or Min"
-    //     This results in year -> single value
-    std::vector<std::pair<int, double>> yearlyData; // (year, temperature)
-
-    for (const auto& kv : yearToTemps)
-    {
-        // kv.first = year, kv.second = vector<double>
-        int year = kv.first;
-        const std::vector<double>& temps = kv.second;
-
-        if (temps.empty()) continue;
-
-        // Aggregate
-        double finalVal = 0.0;
-
-        if (dataType == 1) {
-            // Average: sum / count
-            double sum = 0.0;
-            for (double t : temps) sum += t;
-            finalVal = sum / temps.size();
-        }
-        else if (dataType == 2) {
-            // Max
-            finalVal = *std::max_element(temps.begin(), temps.end());
-        }
-        else {
-            // Min
-            finalVal = *std::min_element(temps.begin(), temps.end());
-        }
-
-        yearlyData.emplace_back(year, finalVal);
-    }
+    // (4) Aggregate each period as "Average or Max or Min", read from the rollup
+    //     This results in period -> single value, in ascending order
+    std::vector<std::pair<int, double>> periodData = collectPeriodValues(countryCode, targetIndex, granularity, dataType, percentile);
 
-    if (yearlyData.empty()) {
+    if (periodData.empty()) {
         std::cout << "\nNo data available for the specified country code \"" << countryCode << "\".\n";
         return;
     }
 
-    // Sort years in ascending order
-    std::sort(yearlyData.begin(), yearlyData.end(),
-        [](const std::pair<int, double>& a, const std::pair<int, double>& b) -> bool {
-            return a.first < b.first;
+    // Keep each bucket's lowest and highest bar when there are more periods than fit the terminal
+    const size_t barColumns = 5;
+    size_t periodCount = periodData.size();
+    size_t width = TextFrame::terminalWidth(FALLBACK_WIDTH);
+    if (width >= 9 + 2 * barColumns) {
+        size_t bars = (width - 9) / barColumns;
+        std::vector<double> values(periodData.size());
+        for (size_t i = 0; i < periodData.size(); ++i) {
+            values[i] = periodData[i].second;
         }
-    );
+        std::vector<size_t> kept = Downsampler::minMax(values.data(), values.size(), bars / 2);
+        if (kept.size() < periodData.size()) {
+            std::vector<std::pair<int, double>> reduced;
+            reduced.reserve(kept.size());
+            for (size_t index : kept) {
+                reduced.push_back(periodData[index]);
+            }
+            periodData.swap(reduced);
+        }
+    }
 
     // (5) Prepare scaling for histogram
     //     Find the maximum value on the Y-axis and draw vertical bars as text
     double maxVal = std::numeric_limits<double>::lowest();
     double minVal = std::numeric_limits<double>::max();
-    for (const auto& p : yearlyData) {
+    for (const auto& p : periodData) {
         double val = p.second;
         if (val > maxVal) maxVal = val;
         if (val < minVal) minVal = val;
@@ -552,63 +1012,60 @@ void MerkelMain::showYearlyHistogram()
     // Scaling
     double scale = static_cast<double>(chartHeight) / range;
 
-    // (6) Draw each row from top to bottom
-    std::cout << "\n===== Yearly "
-              << ((dataType == 1) ? "Average" : (dataType == 2) ? "Max" : "Min")
-              << " Temp for " << countryCode << " =====\n\n";
+    // (6) Draw each row from top to bottom into one frame: a title block, the bars, the X-axis
+    std::ostringstream title;
+    title << "===== " << WeatherRollup::granularityAdjective(granularity) << " "
+          << dataTypeName(dataType, percentile)
+          << " Temp for " << countryCode << " =====";
 
     // Ensure space for Y-axis labels (e.g., 6 characters)
     const int labelWidth = 6;
+    const size_t bodyColumn = labelWidth + 3; // Label + " ┃ "
+    const size_t titleRows = 3;
+    TextFrame frame(std::max(bodyColumn + periodData.size() * barColumns, title.str().size()), titleRows + chartHeight + 2);
+    frame.text(1, 0, title.str());
 
     // row: chartHeight ~ 0
     for (int row = chartHeight; row >= 0; --row)
     {
-        // Calculate Y-axis label
+        size_t line = titleRows + static_cast<size_t>(chartHeight - row);
+
+        // Calculate Y-axis label, right-aligned with 1 decimal place
         double currentVal = minVal + (range * row / chartHeight);
-        // Format label with fixed width (1 decimal place)
         std::ostringstream labelStream;
-        labelStream << std::fixed << std::setprecision(1) << currentVal;
-        std::string label = labelStream.str();
+        labelStream << std::fixed << std::setprecision(1) << std::setw(labelWidth) << currentVal;
+        frame.text(line, 0, labelStream.str() + " ┃ ");
 
-        // Right-align the label
-        std::cout << std::setw(labelWidth) << label << " ┃ ";
-
-        // Loop through each year's data
-        for (size_t i = 0; i < yearlyData.size(); ++i)
+        // Loop through each period's data
+        for (size_t i = 0; i < periodData.size(); ++i)
         {
-            double val = yearlyData[i].second;
+            double val = periodData[i].second;
             // Height on scale
             int barHeight = static_cast<int>((val - minVal) * scale);
 
-            // If current row is within the bar height, draw "#", else " "
+            // If current row is within the bar height, draw a block, else leave it blank
             // Note: row == 0 is the baseline
             if (row <= barHeight - 1) {
-                // Draw '#'
-                std::cout << "  █  ";
-            } else {
-                std::cout << "     ";
+                frame.put(line, bodyColumn + i * barColumns + 2, "█");
             }
         }
-        std::cout << "\n";
     }
 
-    // (7) Output X-axis (year) labels
-    //     Combine into one line below the histogram
-    //     If there are too many years, it may overlap, so adjust as needed
-    //     implementation: write yearInt on one line
-
-    // Add space before X-axis labels (label width + ' | ')
-    std::cout << std::setw(labelWidth + 2) << " " << " ";
-
-    for (size_t i = 0; i < yearlyData.size(); ++i)
+    // (7) Output X-axis (period) labels on one line below the histogram
+    //     Allocate approximately 5 characters for each period; finer periods keep the tail of their label
+    size_t axisColumn = bodyColumn;
+    for (size_t i = 0; i < periodData.size(); ++i)
     {
-        int yearInt = yearlyData[i].first;
-        // Allocate approximately 5 characters for each year
+        std::string label = WeatherRollup::periodLabel(granularity, periodData[i].first);
+        if (label.size() > 5) {
+            label = label.substr(label.size() - 5);
+        }
         std::ostringstream oss;
-        oss << std::setw(5) << yearInt;
-        std::cout << oss.str();
+        oss << std::setw(5) << label;
+        axisColumn = frame.text(titleRows + chartHeight + 1, axisColumn, oss.str());
     }
-    std::cout << "\n";
+    frame.print();
+    noteDownsampled(periodCount, periodData.size(), "bars");
 }
 
 // ─────────────────────────────────────────────
@@ -621,59 +1078,36 @@ void MerkelMain::predictFutureTemperature()
         return; // Input error
     }
 
-    // Get temperature data for the specified country from CSV
-    std::vector<Candlestick> candles = computeCandlestickDataForCountry(countryCode);
-    if (candles.empty()) {
-        std::cerr << "No candlestick data computed. "
-                  << "Check if the country code is correct and data is available.\n";
-        return;
-    }
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
 
-    // Extract data points as (year, average temperature)
-    std::vector<std::pair<int, double>> dataPoints; // (year, average temperature)
-    for (const auto& candle : candles) {
-        int year = 0;
-        try {
-            year = std::stoi(candle.date.substr(0, 4));
-        } catch (...) {
-            continue; // Skip invalid year
-        }
-        dataPoints.emplace_back(year, candle.close); // Assuming 'close' represents average temperature
+    // Get data points as (period, average temperature) for the specified country from the rollup
+    int column = weatherTable.schema().columnIndex(countryCode, WeatherSchema::TEMPERATURE);
+    if (column == -1) {
+        std::cerr << "Error: Country code " << countryCode << " not found in headers." << std::endl;
+        return;
     }
+    std::vector<std::pair<int, double>> dataPoints = collectPeriodValues(countryCode, column, granularity, 1);
 
     if (dataPoints.size() < 2) {
         std::cerr << "Not enough data points for regression analysis.\n";
         return;
     }
 
-    // Calculate sums for regression
-    double sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0;
-    int n = dataPoints.size();
-    for (const auto& point : dataPoints) {
-        sumX += point.first;
-        sumY += point.second;
-        sumXY += point.first * point.second;
-        sumX2 += point.first * point.first;
-    }
-
-    // linear regression formula: Y = slope * X + intercept
-    double denominator = n * sumX2 - sumX * sumX;
-    if (denominator == 0.0) {
+    // linear regression formula: Y = slope * X + intercept, from the country's running statistics
+    RegressionEngine::Fit fit = regressionFor(granularity).fit(static_cast<size_t>(column));
+    if (!fit.valid) {
         std::cerr << "Denominator is zero. Cannot perform regression.\n";
         return;
     }
-
-    // Calculate regression coefficients
-    double slope = (n * sumXY - sumX * sumY) / denominator;
-    // Y-intercept
-    double intercept = (sumY * sumX2 - sumX * sumXY) / denominator;
+    double slope = fit.slope;
+    double intercept = fit.intercept;
 
     std::cout << "\n=== Linear Regression ===\n";
     std::cout << "Equation: Y = " << slope << " * X + " << intercept << "\n";
 
     // Get the number of future years to predict from the user
     int futureYears = 0;
-    std::cout << "Enter the number of future years to predict: ";
+    std::cout << "Enter the number of future " << WeatherRollup::granularityName(granularity) << "s to predict: ";
     std::string line;
     std::getline(std::cin, line);
     try {
@@ -685,33 +1119,69 @@ void MerkelMain::predictFutureTemperature()
     }
 
     if (futureYears <= 0) {
-        std::cerr << "Number of future years must be positive.\n";
+        std::cerr << "Number of future periods must be positive.\n";
         return;
     }
 
-    // Use the last data point's year as the base for prediction
+    // Use the last data point's period as the base for prediction
+    bool yearly = (granularity == WeatherRollup::Granularity::Year);
     int lastYear = dataPoints.back().first;
     std::cout << "\n=== Predicted Temperatures ===\n";
-    std::cout << "Year\tPredicted Temperature\n";
-    std::vector<std::pair<int, double>> predictedData; // (year, predicted temperature)
+    std::cout << (yearly ? "Year" : "Period") << "\tPredicted Temperature\n";
+    std::vector<std::pair<int, double>> predictedData; // (period, predicted temperature)
     for (int i = 1; i <= futureYears; ++i) {
         int predictYear = lastYear + i;
         double predictedTemp = slope * predictYear + intercept;
         predictedData.emplace_back(predictYear, predictedTemp);
-        std::cout << predictYear << "\t" << std::fixed << std::setprecision(3) << predictedTemp << "\n";
+        if (yearly) {
+            std::cout << predictYear;
+        } else {
+            std::cout << WeatherRollup::periodLabel(granularity, predictYear);
+        }
+        std::cout << "\t" << std::fixed << std::setprecision(3) << predictedTemp << "\n";
     }
 
     // (9) Plot the prediction
-    plotPrediction(dataPoints, predictedData);
+    plotPrediction(dataPoints, predictedData, granularity);
 }
 
 // ─────────────────────────────────────────────
 // (Menu 5) Plot Prediction Data as Text
 // ─────────────────────────────────────────────
-void MerkelMain::plotPrediction(const std::vector<std::pair<int, double>>& pastData, const std::vector<std::pair<int, double>>& predictedData) const
+void MerkelMain::plotPrediction(const std::vector<std::pair<int, double>>& pastData, const std::vector<std::pair<int, double>>& predictedData,
+                                WeatherRollup::Granularity granularity, const std::string& title) const
 {
-    std::vector<std::pair<int, double>> allData = pastData;
-    allData.insert(allData.end(), predictedData.begin(), predictedData.end());
+    // Thin both parts with LTTB when there are more points than columns (3 cells per point),
+    // sharing the columns in proportion to their lengths
+    std::vector<std::pair<int, double>> allData;
+    size_t pastCount = pastData.size();
+    size_t width = TextFrame::terminalWidth(FALLBACK_WIDTH);
+    size_t total = pastData.size() + predictedData.size();
+    if (width >= 8 + 3 * 4 && total > (width - 8) / 3) {
+        size_t budget = (width - 8) / 3;
+        size_t pastBudget = std::max<size_t>(budget * pastData.size() / total, pastData.empty() ? 0 : 2);
+        size_t predictedBudget = budget > pastBudget ? budget - pastBudget : 0;
+        for (int part = 0; part < 2; ++part) {
+            const std::vector<std::pair<int, double>>& points = (part == 0) ? pastData : predictedData;
+            std::vector<double> x(points.size());
+            std::vector<double> y(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                x[i] = points[i].first;
+                y[i] = points[i].second;
+            }
+            std::vector<size_t> kept = Downsampler::lttb(x.data(), y.data(), points.size(),
+                                                         part == 0 ? pastBudget : predictedBudget);
+            for (size_t index : kept) {
+                allData.push_back(points[index]);
+            }
+            if (part == 0) {
+                pastCount = allData.size();
+            }
+        }
+    } else {
+        allData = pastData;
+        allData.insert(allData.end(), predictedData.begin(), predictedData.end());
+    }
 
     double minVal = std::numeric_limits<double>::max();
     double maxVal = std::numeric_limits<double>::lowest();
@@ -740,42 +1210,963 @@ void MerkelMain::plotPrediction(const std::vector<std::pair<int, double>>& pastD
         scaledValues.push_back(scaled);
     }
 
-    std::cout << "\n=== Temperature Prediction Plot ===\n\n";
+    // Title block, chartHeight rows of points (3 cells each) and the X-axis, drawn as one frame
+    const std::string heading = "=== " + title + " ===";
+    const size_t bodyColumn = 8; // Label (6) + " ┃"
+    const size_t titleRows = 3;
+    TextFrame frame(std::max(bodyColumn + static_cast<size_t>(dataCount) * 3, heading.size()), titleRows + chartHeight + 1);
+    frame.text(1, 0, heading);
+
     for (int row = chartHeight - 1; row >= 0; --row) {
-        // Display Y-axis label
+        size_t line = titleRows + static_cast<size_t>(chartHeight - 1 - row);
+
+        // Display Y-axis label, right-aligned
         double currentVal = minVal + (range * row / (chartHeight - 1));
         std::ostringstream labelStream;
-        labelStream << std::fixed << std::setprecision(1) << currentVal;
-        std::string label = labelStream.str();
-
-        // Right-align the label
-        std::cout << std::setw(6) << label << " ┃";
+        labelStream << std::fixed << std::setprecision(1) << std::setw(6) << currentVal;
+        frame.text(line, 0, labelStream.str() + " ┃");
 
-        // Plot each data point
+        // Plot each data point: blue for the past, green for predictions
         for (int i = 0; i < dataCount; ++i) {
             if (scaledValues[i] == row) {
-                if (i < static_cast<int>(pastData.size())) {
-                    // Blue '*' + space
-                    std::cout << "\033[34m*\033[0m " << " ";
-                }
-                else {
-                    // Green '*' + space
-                    std::cout << "\033[32m*\033[0m " << " ";
-                }
-            }
-            else {
-                std::cout << "  " << " ";
+                bool past = i < static_cast<int>(pastCount);
+                frame.put(line, bodyColumn + static_cast<size_t>(i) * 3, "*",
+                          past ? TextFrame::Color::Blue : TextFrame::Color::Green);
             }
         }
-        std::cout << "\n";
     }
 
-    // Display X-axis labels (years)
-    std::cout << "       ";
+    // Display X-axis labels (years as their last two digits; finer periods show their month or day number)
+    size_t axisColumn = 7;
     for (const auto& p : allData) {
-        // Display only the last two digits
-        int lastTwoDigits = p.first % 100;
-        std::cout << std::setw(2) << lastTwoDigits << " ";
+        int tick = (granularity != WeatherRollup::Granularity::Year) ? WeatherRollup::periodTick(granularity, p.first)
+                                                                      : p.first % 100;
+        std::ostringstream tickStream;
+        if (granularity != WeatherRollup::Granularity::Year) {
+            tickStream << std::setw(2) << std::setfill('0') << tick << " ";
+        } else {
+            tickStream << std::setw(2) << tick << " ";
+        }
+        axisColumn = frame.text(titleRows + chartHeight, axisColumn, tickStream.str());
+    }
+    frame.print();
+    noteDownsampled(total, allData.size(), "points");
+}
+
+// ─────────────────────────────────────────────
+// (Menu 8) Load Rows Appended to the CSV
+// ─────────────────────────────────────────────
+void MerkelMain::refreshData()
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data loaded to refresh." << std::endl;
+        return;
+    }
+
+    // Only the bytes after the last consumed offset are parsed
+    size_t firstNewRow = 0;
+    if (!weatherTable.appendNewRows(dataFilename, firstNewRow, workerCount)) {
+        std::cerr << "Error: Could not read new rows; restart to reload " << dataFilename << "." << std::endl;
+        return;
+    }
+    size_t added = weatherTable.rowCount() - firstNewRow;
+    if (added == 0) {
+        std::cout << "No new rows in " << dataFilename << "." << std::endl;
+        return;
+    }
+
+    // Aggregates absorb the new periods; indexes and cached series described the old rows
+    weatherRollup.append(weatherTable, firstNewRow, workerCount);
+    int64_t firstNewTimestamp = weatherTable.timestamps()[firstNewRow];
+    for (RegressionEngine& engine : regressions) {
+        engine.update(weatherRollup, WeatherRollup::periodOf(engine.granularity(), firstNewTimestamp));
     }
-    std::cout << "\n";
-}
\ No newline at end of file
+    windowIndex.attach(weatherTable);
+    seriesCache.clear();
+    lastComputedCandles.clear();
+
+    int year = 0, month = 0, day = 0;
+    TimeUtils::toCivil(weatherTable.timestamps()[weatherTable.rowCount() - 1], year, month, day);
+    std::cout << "Loaded " << added << " new rows (" << weatherTable.rowCount() << " in total, through "
+              << year << "-" << std::setw(2) << std::setfill('0') << month << "-" << std::setw(2) << day
+              << std::setfill(' ') << ")." << std::endl;
+}
+
+// ─────────────────────────────────────────────
+// (Menu 9) Linear Trend Forecast for Every Country
+// ─────────────────────────────────────────────
+void MerkelMain::forecastAllCountries()
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available for regression analysis." << std::endl;
+        return;
+    }
+
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+    std::cout << "Enter the number of future " << WeatherRollup::granularityName(granularity) << "s to predict: ";
+    std::string line;
+    std::getline(std::cin, line);
+    int futurePeriods = 0;
+    try {
+        futurePeriods = std::stoi(line);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Invalid input for future periods.\n";
+        return;
+    }
+    if (futurePeriods <= 0) {
+        std::cerr << "Number of future periods must be positive.\n";
+        return;
+    }
+
+    // Every country was fitted in the same pass; each row here is a lookup
+    const RegressionEngine& engine = regressionFor(granularity);
+    const WeatherSchema& schema = weatherTable.schema();
+    std::cout << "\n=== " << WeatherRollup::granularityAdjective(granularity) << " Trend Forecast : all countries ===\n";
+    std::cout << "Country\tPoints\tSlope\tLast\tNext\tTarget\tForecast\n";
+    for (const std::string& country : schema.countries()) {
+        int column = schema.columnIndex(country, WeatherSchema::TEMPERATURE);
+        if (column == -1) {
+            continue;
+        }
+        RegressionEngine::Fit fit = engine.fit(static_cast<size_t>(column));
+        if (!fit.valid) {
+            std::cout << country << "\t" << fit.points << "\t(not enough data)\n";
+            continue;
+        }
+        int64_t target = fit.lastPeriod + futurePeriods;
+        std::cout << country << "\t"
+                  << fit.points << "\t"
+                  << std::fixed << std::setprecision(4) << fit.slope << "\t"
+                  << WeatherRollup::periodLabel(granularity, fit.lastPeriod) << "\t"
+                  << std::setprecision(3) << fit.predict(fit.lastPeriod + 1) << "\t"
+                  << WeatherRollup::periodLabel(granularity, target) << "\t"
+                  << fit.predict(target) << "\n";
+    }
+}
+
+// ─────────────────────────────────────────────
+// (Menu 10) Seasonal Forecast from the Hourly Readings
+// ─────────────────────────────────────────────
+void MerkelMain::predictSeasonalTemperature()
+{
+    std::string countryCode = getCountryCodeFromUser();
+    if (countryCode.empty()) {
+        return; // Input error
+    }
+    int column = weatherTable.schema().columnIndex(countryCode, WeatherSchema::TEMPERATURE);
+    if (column == -1) {
+        std::cerr << "Error: Country code " << countryCode << " not found in headers." << std::endl;
+        return;
+    }
+
+    // Every hourly reading goes into the normal equations
+    SeasonalModel model;
+    auto start = std::chrono::steady_clock::now();
+    if (!model.fit(weatherTable.timestamps(), weatherTable.column(static_cast<size_t>(column)), weatherTable.rowCount(), workerCount)) {
+        std::cerr << "Not enough data points for regression analysis.\n";
+        return;
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n=== Seasonal Regression (" << countryCode << ") ===\n";
+    std::cout << std::fixed << std::setprecision(3)
+              << "Readings: " << model.points() << " (" << model.featureCount() << " terms, fitted in "
+              << std::setprecision(1) << elapsedMs << " ms)\n"
+              << std::setprecision(3)
+              << "Trend: " << model.trendPerYear() * 10.0 << " per decade\n"
+              << "Yearly cycle amplitude: " << model.annualAmplitude() << "\n"
+              << "Daily cycle amplitude: " << model.diurnalAmplitude() << "\n"
+              << "RMSE: " << model.rmse() << ", R^2: " << model.rSquared() << "\n";
+
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+    std::vector<std::pair<int, double>> pastData = collectPeriodValues(countryCode, column, granularity, 1);
+    if (pastData.empty()) {
+        std::cerr << "No data available for " << countryCode << ".\n";
+        return;
+    }
+
+    std::cout << "Enter the number of future " << WeatherRollup::granularityName(granularity) << "s to predict: ";
+    std::string line;
+    std::getline(std::cin, line);
+    int futurePeriods = 0;
+    try {
+        futurePeriods = std::stoi(line);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Invalid input for future periods.\n";
+        return;
+    }
+    if (futurePeriods <= 0) {
+        std::cerr << "Number of future periods must be positive.\n";
+        return;
+    }
+
+    // Forecast of a period = mean of the model over its hours
+    bool yearly = (granularity == WeatherRollup::Granularity::Year);
+    int lastPeriod = pastData.back().first;
+    std::cout << "\n=== Predicted Temperatures ===\n";
+    std::cout << (yearly ? "Year" : "Period") << "\tPredicted Temperature\n";
+    std::vector<std::pair<int, double>> predictedData;
+    for (int i = 1; i <= futurePeriods; ++i) {
+        int period = lastPeriod + i;
+        double predicted = model.periodMean(granularity, period);
+        predictedData.emplace_back(period, predicted);
+        std::cout << WeatherRollup::periodLabel(granularity, period) << "\t"
+                  << std::fixed << std::setprecision(3) << predicted << "\n";
+    }
+
+    plotPrediction(pastData, predictedData, granularity);
+}
+
+// ─────────────────────────────────────────────
+// Evenly Spaced Period Means for the Forecasting Models
+// ─────────────────────────────────────────────
+std::vector<double> MerkelMain::forecastSeries(const std::string& countryCode, int column,
+                                               WeatherRollup::Granularity granularity, int& firstPeriod)
+{
+    std::vector<std::pair<int, double>> points = collectPeriodValues(countryCode, column, granularity, 1);
+    firstPeriod = points.empty() ? 0 : points.front().first;
+    return Forecaster::fillGaps(points);
+}
+
+// ─────────────────────────────────────────────
+// (Menu 11) Holt-Winters / ARIMA Forecast of One Country
+// ─────────────────────────────────────────────
+void MerkelMain::forecastWithModels()
+{
+    std::string countryCode = getCountryCodeFromUser();
+    if (countryCode.empty()) {
+        return; // Input error
+    }
+    int column = weatherTable.schema().columnIndex(countryCode, WeatherSchema::TEMPERATURE);
+    if (column == -1) {
+        std::cerr << "Error: Country code " << countryCode << " not found in headers." << std::endl;
+        return;
+    }
+
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+    Forecaster::Method method = Forecaster::Method::Best;
+    if (!getForecastMethodFromUser(method)) {
+        return;
+    }
+
+    int firstPeriod = 0;
+    std::vector<double> values = forecastSeries(countryCode, column, granularity, firstPeriod);
+    if (values.size() < 3) {
+        std::cerr << "Not enough data points for a forecast.\n";
+        return;
+    }
+
+    std::cout << "Enter the number of future " << WeatherRollup::granularityName(granularity) << "s to predict: ";
+    std::string line;
+    std::getline(std::cin, line);
+    int futurePeriods = 0;
+    try {
+        futurePeriods = std::stoi(line);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Invalid input for future periods.\n";
+        return;
+    }
+    if (futurePeriods <= 0) {
+        std::cerr << "Number of future periods must be positive.\n";
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Forecaster::Result result = Forecaster::forecast(values, Forecaster::seasonLength(granularity), method,
+                                                     futurePeriods, forecastPool);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!result.valid) {
+        std::cerr << "Could not fit a " << Forecaster::methodName(method) << " model to " << countryCode << ".\n";
+        return;
+    }
+
+    std::cout << "\n=== " << Forecaster::methodName(method) << " (" << countryCode << ") ===\n";
+    std::cout << "Model: " << result.model << "\n"
+              << std::fixed << std::setprecision(3)
+              << "Points: " << values.size() << ", RMSE: " << result.rmse << ", AIC: " << result.aic
+              << " (fitted in " << std::setprecision(1) << elapsedMs << " ms)\n";
+
+    bool yearly = (granularity == WeatherRollup::Granularity::Year);
+    int lastPeriod = firstPeriod + static_cast<int>(values.size()) - 1;
+    std::cout << "\n=== Predicted Temperatures ===\n";
+    std::cout << (yearly ? "Year" : "Period") << "\tPredicted Temperature\n";
+    std::vector<std::pair<int, double>> predictedData;
+    for (int i = 1; i <= futurePeriods; ++i) {
+        int period = lastPeriod + i;
+        double predicted = result.forecast[static_cast<size_t>(i - 1)];
+        predictedData.emplace_back(period, predicted);
+        std::cout << WeatherRollup::periodLabel(granularity, period) << "\t"
+                  << std::fixed << std::setprecision(3) << predicted << "\n";
+    }
+
+    plotPrediction(collectPeriodValues(countryCode, column, granularity, 1), predictedData, granularity);
+}
+
+// ─────────────────────────────────────────────
+// (Menu 12) Holt-Winters / ARIMA Forecast Report for Every Country
+// ─────────────────────────────────────────────
+void MerkelMain::forecastReportAllCountries()
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available for forecasting." << std::endl;
+        return;
+    }
+
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+    Forecaster::Method method = Forecaster::Method::Best;
+    if (!getForecastMethodFromUser(method)) {
+        return;
+    }
+    std::cout << "Enter the number of future " << WeatherRollup::granularityName(granularity) << "s to predict: ";
+    std::string line;
+    std::getline(std::cin, line);
+    int futurePeriods = 0;
+    try {
+        futurePeriods = std::stoi(line);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Invalid input for future periods.\n";
+        return;
+    }
+    if (futurePeriods <= 0) {
+        std::cerr << "Number of future periods must be positive.\n";
+        return;
+    }
+
+    // One batch: the candidates of all countries share the pool
+    const WeatherSchema& schema = weatherTable.schema();
+    std::vector<std::string> countries;
+    std::vector<std::vector<double>> series;
+    std::vector<int> firstPeriods;
+    for (const std::string& country : schema.countries()) {
+        int column = schema.columnIndex(country, WeatherSchema::TEMPERATURE);
+        if (column == -1) {
+            continue;
+        }
+        int firstPeriod = 0;
+        series.push_back(forecastSeries(country, column, granularity, firstPeriod));
+        countries.push_back(country);
+        firstPeriods.push_back(firstPeriod);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Forecaster::Result> results = Forecaster::forecastAll(series, Forecaster::seasonLength(granularity), method,
+                                                                      futurePeriods, forecastPool);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n=== " << WeatherRollup::granularityAdjective(granularity) << " " << Forecaster::methodName(method)
+              << " Forecast : all countries ===\n";
+    std::cout << "Country\tPoints\tRMSE\tNext\tTarget\tForecast\tModel\n";
+    for (size_t i = 0; i < countries.size(); ++i) {
+        const Forecaster::Result& result = results[i];
+        if (!result.valid) {
+            std::cout << countries[i] << "\t" << series[i].size() << "\t(not enough data)\n";
+            continue;
+        }
+        int target = firstPeriods[i] + static_cast<int>(series[i].size()) - 1 + futurePeriods;
+        std::cout << countries[i] << "\t"
+                  << series[i].size() << "\t"
+                  << std::fixed << std::setprecision(3) << result.rmse << "\t"
+                  << result.forecast.front() << "\t"
+                  << WeatherRollup::periodLabel(granularity, target) << "\t"
+                  << result.forecast.back() << "\t"
+                  << result.model << "\n";
+    }
+    std::cout << countries.size() << " countries fitted in " << std::setprecision(1) << elapsedMs << " ms on "
+              << forecastPool.size() << " worker(s)\n";
+}
+
+// ─────────────────────────────────────────────
+// (Menu 13) Rolling-Origin Backtest of the Forecast Models
+// ─────────────────────────────────────────────
+void MerkelMain::backtestForecastModels()
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available for backtesting." << std::endl;
+        return;
+    }
+
+    WeatherRollup::Granularity granularity = getGranularityFromUser();
+    std::cout << "Enter the forecast horizon in " << WeatherRollup::granularityName(granularity) << "s: ";
+    std::string line;
+    std::getline(std::cin, line);
+    int horizon = 0;
+    try {
+        horizon = std::stoi(line);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Invalid input for the horizon.\n";
+        return;
+    }
+    if (horizon <= 0) {
+        std::cerr << "Horizon must be positive.\n";
+        return;
+    }
+    std::cout << "Number of cutoffs, one year apart [10]: ";
+    std::getline(std::cin, line);
+    int cutoffCount = 10;
+    if (!line.empty()) {
+        try {
+            cutoffCount = std::stoi(line);
+        }
+        catch (const std::exception&) {
+            cutoffCount = 0;
+        }
+        if (cutoffCount <= 0) {
+            std::cerr << "Number of cutoffs must be positive.\n";
+            return;
+        }
+    }
+
+    // Period series of every country, shared by all folds
+    const WeatherSchema& schema = weatherTable.schema();
+    std::vector<std::string> countries;
+    std::vector<std::vector<double>> series;
+    std::vector<int64_t> firstPeriods;
+    int64_t lastPeriod = std::numeric_limits<int64_t>::min();
+    for (const std::string& country : schema.countries()) {
+        int column = schema.columnIndex(country, WeatherSchema::TEMPERATURE);
+        if (column == -1) {
+            continue;
+        }
+        int firstPeriod = 0;
+        std::vector<double> values = forecastSeries(country, column, granularity, firstPeriod);
+        if (values.empty()) {
+            continue;
+        }
+        lastPeriod = std::max(lastPeriod, static_cast<int64_t>(firstPeriod) + static_cast<int64_t>(values.size()) - 1);
+        countries.push_back(country);
+        series.push_back(std::move(values));
+        firstPeriods.push_back(firstPeriod);
+    }
+    if (series.empty()) {
+        std::cerr << "No data available for backtesting.\n";
+        return;
+    }
+
+    // The latest cutoff leaves exactly one horizon of data; earlier ones step back a year at a time
+    int64_t step = Forecaster::seasonLength(granularity);
+    std::vector<int64_t> cutoffs;
+    for (int k = cutoffCount - 1; k >= 0; --k) {
+        cutoffs.push_back(lastPeriod + 1 - horizon - k * step);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Backtester::Report report = Backtester::run(series, firstPeriods, cutoffs, horizon,
+                                                Forecaster::seasonLength(granularity), forecastPool);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n=== " << WeatherRollup::granularityAdjective(granularity) << " Backtest : " << cutoffs.size()
+              << " cutoffs from " << WeatherRollup::periodLabel(granularity, cutoffs.front())
+              << " to " << WeatherRollup::periodLabel(granularity, cutoffs.back())
+              << ", horizon " << horizon << " ===\n";
+    std::cout << "Each cell is MAE/RMSE over every fold and forecast step; all models are scored on the same folds\n";
+    std::cout << "Country\tFolds";
+    for (size_t m = 0; m < Backtester::MODEL_COUNT; ++m) {
+        std::cout << "\t" << Backtester::modelName(static_cast<Backtester::Model>(m));
+    }
+    std::cout << "\tBest\n";
+
+    auto printRow = [](const std::string& name, size_t folds, const std::vector<Backtester::Score>& scores) {
+        std::cout << name << "\t" << folds;
+        size_t best = 0;
+        for (size_t m = 0; m < scores.size(); ++m) {
+            std::cout << "\t" << std::fixed << std::setprecision(3) << scores[m].mae() << "/" << scores[m].rmse();
+            if (scores[m].count > 0 && (scores[best].count == 0 || scores[m].rmse() < scores[best].rmse())) {
+                best = m;
+            }
+        }
+        std::cout << "\t" << (scores[best].count > 0 ? Backtester::modelName(static_cast<Backtester::Model>(best)) : "-")
+                  << "\n";
+    };
+
+    std::vector<Backtester::Score> total(Backtester::MODEL_COUNT);
+    size_t totalFolds = 0;
+    for (size_t i = 0; i < countries.size(); ++i) {
+        if (report.folds[i] == 0) {
+            std::cout << countries[i] << "\t0\t(not enough data)\n";
+            continue;
+        }
+        printRow(countries[i], report.folds[i], report.scores[i]);
+        for (size_t m = 0; m < Backtester::MODEL_COUNT; ++m) {
+            total[m].merge(report.scores[i][m]);
+        }
+        totalFolds += report.folds[i];
+    }
+    printRow("All", totalFolds, total);
+    if (report.dropped > 0) {
+        std::cout << report.dropped << " fold(s) left out for every model: Holt-Winters or ARIMA could not fit them\n";
+    }
+    std::cout << totalFolds << " folds x " << Backtester::MODEL_COUNT << " models in " << std::setprecision(1) << elapsedMs
+              << " ms on " << forecastPool.size() << " worker(s)\n";
+}
+
+// ─────────────────────────────────────────────
+// Get Countries to Export from User
+// ─────────────────────────────────────────────
+std::vector<std::string> MerkelMain::getExportCountriesFromUser()
+{
+    std::cout << "Enter country code, or \"all\" for every country [all]: ";
+    std::string line;
+    std::getline(std::cin, line);
+    const WeatherSchema& schema = weatherTable.schema();
+    std::vector<std::string> countries;
+    if (line.empty() || line == "all" || line == "ALL") {
+        for (const std::string& country : schema.countries()) {
+            if (schema.columnIndex(country, WeatherSchema::TEMPERATURE) != -1) {
+                countries.push_back(country);
+            }
+        }
+    } else if (schema.columnIndex(line, WeatherSchema::TEMPERATURE) != -1) {
+        countries.push_back(line);
+    } else {
+        std::cerr << "Error: Country code " << line << " not found in headers." << std::endl;
+    }
+    return countries;
+}
+
+// ─────────────────────────────────────────────
+// (Menu 14) Export Results to a File
+// ─────────────────────────────────────────────
+void MerkelMain::exportData()
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available to export." << std::endl;
+        return;
+    }
+
+    std::cout << "1: Candlesticks\n"
+              << "2: Period values (average, max, min or percentile)\n"
+              << "3: Holt-Winters / ARIMA forecasts\n"
+              << "4: Every hourly reading (all countries)\n"
+              << ">> ";
+    std::string line;
+    std::getline(std::cin, line);
+    int kind = 0;
+    try {
+        kind = std::stoi(line);
+    }
+    catch (const std::exception&) {
+        kind = 0;
+    }
+    if (kind < 1 || kind > 4) {
+        std::cerr << "Invalid export type.\n";
+        return;
+    }
+
+    // Questions specific to each kind come first; the file is opened once they are answered
+    std::vector<std::string> countries;
+    WeatherRollup::Granularity granularity = WeatherRollup::Granularity::Year;
+    int dataType = 1;
+    double percentile = 50.0;
+    Forecaster::Method method = Forecaster::Method::Best;
+    int futurePeriods = 0;
+    if (kind != 4) {
+        countries = getExportCountriesFromUser();
+        if (countries.empty()) {
+            return;
+        }
+        if (kind == 2) {
+            dataType = getDataTypeFromUser(percentile);
+            if (dataType < 1) {
+                return;
+            }
+        }
+        granularity = getGranularityFromUser();
+        if (kind == 3) {
+            if (!getForecastMethodFromUser(method)) {
+                return;
+            }
+            std::cout << "Enter the number of future " << WeatherRollup::granularityName(granularity) << "s to predict: ";
+            std::getline(std::cin, line);
+            try {
+                futurePeriods = std::stoi(line);
+            }
+            catch (const std::exception&) {
+                futurePeriods = 0;
+            }
+            if (futurePeriods <= 0) {
+                std::cerr << "Number of future periods must be positive.\n";
+                return;
+            }
+        }
+    }
+
+    std::cout << "Format (csv, jsonl, bin) [csv]: ";
+    std::getline(std::cin, line);
+    Exporter::Format format = Exporter::Format::CSV;
+    if (!line.empty() && !Exporter::parseFormat(line, format)) {
+        std::cerr << "Unknown format \"" << line << "\".\n";
+        return;
+    }
+    static const char* const KIND_NAMES[] = {"", "candles", "values", "forecasts", "readings"};
+    std::string defaultName = std::string("../export_") + KIND_NAMES[kind] + "." + Exporter::extension(format);
+    std::cout << "Output file [" << defaultName << "]: ";
+    std::getline(std::cin, line);
+    std::string filename = line.empty() ? defaultName : line;
+
+    std::vector<Exporter::Column> columns;
+    const WeatherSchema& schema = weatherTable.schema();
+    if (kind == 4) {
+        // Wide layout like the input CSV: one row per timestamp, one column per country
+        if (format == Exporter::Format::Binary) {
+            columns.push_back({"epoch", Exporter::Type::Integer});
+        } else {
+            columns.push_back({"utc_timestamp", Exporter::Type::Text});
+        }
+        for (size_t column : temperatureColumns) {
+            columns.push_back({weatherTable.columnName(column), Exporter::Type::Real});
+        }
+    } else {
+        columns.push_back({"country", Exporter::Type::Text});
+        columns.push_back({"period", Exporter::Type::Text});
+        if (kind == 1) {
+            for (const char* name : {"open", "high", "low", "close"}) {
+                columns.push_back({name, Exporter::Type::Real});
+            }
+        } else if (kind == 2) {
+            columns.push_back({aggregateKey(dataType, percentile), Exporter::Type::Real});
+        } else {
+            columns.push_back({"forecast", Exporter::Type::Real});
+            columns.push_back({"model", Exporter::Type::Text});
+        }
+    }
+
+    Exporter exporter;
+    if (!exporter.open(filename, format, columns)) {
+        std::cerr << "Error: Could not create " << filename << "." << std::endl;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    if (kind == 1) {
+        // Each country's candles are written as soon as they are computed
+        for (const std::string& country : countries) {
+            for (const Candlestick& candle : computeCandlestickDataForCountry(country, granularity)) {
+                exporter.text(country);
+                exporter.text(candle.label());
+                exporter.real(candle.open);
+                exporter.real(candle.high);
+                exporter.real(candle.low);
+                exporter.real(candle.close);
+                exporter.endRecord();
+            }
+        }
+    } else if (kind == 2) {
+        for (const std::string& country : countries) {
+            int column = schema.columnIndex(country, WeatherSchema::TEMPERATURE);
+            for (const auto& point : collectPeriodValues(country, column, granularity, dataType, percentile)) {
+                exporter.text(country);
+                exporter.text(WeatherRollup::periodLabel(granularity, point.first));
+                exporter.real(point.second);
+                exporter.endRecord();
+            }
+        }
+    } else if (kind == 3) {
+        std::vector<std::vector<double>> series;
+        std::vector<int> firstPeriods;
+        for (const std::string& country : countries) {
+            int firstPeriod = 0;
+            series.push_back(forecastSeries(country, schema.columnIndex(country, WeatherSchema::TEMPERATURE), granularity, firstPeriod));
+            firstPeriods.push_back(firstPeriod);
+        }
+        std::vector<Forecaster::Result> results = Forecaster::forecastAll(series, Forecaster::seasonLength(granularity), method,
+                                                                          futurePeriods, forecastPool);
+        for (size_t i = 0; i < countries.size(); ++i) {
+            if (!results[i].valid) {
+                continue;
+            }
+            int lastPeriod = firstPeriods[i] + static_cast<int>(series[i].size()) - 1;
+            for (int h = 0; h < futurePeriods; ++h) {
+                exporter.text(countries[i]);
+                exporter.text(WeatherRollup::periodLabel(granularity, lastPeriod + 1 + h));
+                exporter.real(results[i].forecast[static_cast<size_t>(h)]);
+                exporter.text(results[i].model);
+                exporter.endRecord();
+            }
+        }
+    } else {
+        // Straight from the typed columns; timestamps are formatted without allocating
+        const int64_t* timestamps = weatherTable.timestamps();
+        std::vector<const double*> values;
+        for (size_t column : temperatureColumns) {
+            values.push_back(weatherTable.column(column));
+        }
+        char stamp[TimeUtils::TIMESTAMP_LENGTH];
+        for (size_t row = 0; row < weatherTable.rowCount(); ++row) {
+            if (format == Exporter::Format::Binary) {
+                exporter.integer(timestamps[row]);
+            } else {
+                TimeUtils::formatTimestamp(timestamps[row], stamp);
+                exporter.text(std::string_view(stamp, sizeof(stamp)));
+            }
+            for (const double* column : values) {
+                exporter.real(column[row]);
+            }
+            exporter.endRecord();
+        }
+    }
+
+    size_t records = exporter.records();
+    bool ok = exporter.close();
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) {
+        std::cerr << "Error: Writing " << filename << " failed." << std::endl;
+        return;
+    }
+    std::cout << "Exported " << records << " records (" << exporter.bytesWritten() / 1024 << " KiB) to " << filename
+              << " in " << std::fixed << std::setprecision(1) << elapsedMs << " ms\n";
+}
+
+// ─────────────────────────────────────────────
+// Batch Mode: Run Queries without Prompts
+// ─────────────────────────────────────────────
+size_t MerkelMain::runBatch(const std::vector<std::string>& queries)
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available to run queries." << std::endl;
+        return queries.size();
+    }
+
+    const WeatherSchema& schema = weatherTable.schema();
+    size_t count = queries.size();
+    std::vector<BatchQuery> parsed(count);
+    std::vector<std::string> outputs(count);
+    std::vector<std::string> errors(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (BatchQuery::parse(queries[i], parsed[i], errors[i]) &&
+            schema.columnIndex(parsed[i].country, WeatherSchema::TEMPERATURE) == -1) {
+            errors[i] = "country code " + parsed[i].country + " not found in headers";
+        }
+    }
+
+    // Trend fits are built on first use; build the ones needed before queries share them
+    for (size_t i = 0; i < count; ++i) {
+        if (errors[i].empty() && parsed[i].kind == BatchQuery::Kind::Forecast && parsed[i].linear) {
+            regressionFor(parsed[i].granularity);
+        }
+    }
+
+    // Holt-Winters / ARIMA: one batch per (granularity, method), so every country of it is
+    // fitted concurrently on the pool; each country is fitted once for its longest horizon
+    std::vector<Forecaster::Result> models(count);
+    std::vector<int> lastPeriods(count, 0);
+    std::map<std::pair<int, int>, std::vector<size_t>> groups;
+    for (size_t i = 0; i < count; ++i) {
+        if (errors[i].empty() && parsed[i].kind == BatchQuery::Kind::Forecast && !parsed[i].linear) {
+            groups[{static_cast<int>(parsed[i].granularity), static_cast<int>(parsed[i].method)}].push_back(i);
+        }
+    }
+    for (const auto& group : groups) {
+        const BatchQuery& first = parsed[group.second.front()];
+        std::map<std::string, size_t> slots;
+        std::vector<std::vector<double>> series;
+        std::vector<int> firstPeriods;
+        int horizon = 0;
+        for (size_t i : group.second) {
+            const std::string& country = parsed[i].country;
+            horizon = std::max(horizon, parsed[i].periods);
+            if (slots.count(country) == 0) {
+                int firstPeriod = 0;
+                slots[country] = series.size();
+                series.push_back(forecastSeries(country, schema.columnIndex(country, WeatherSchema::TEMPERATURE),
+                                                first.granularity, firstPeriod));
+                firstPeriods.push_back(firstPeriod);
+            }
+        }
+        std::vector<Forecaster::Result> results = Forecaster::forecastAll(series, Forecaster::seasonLength(first.granularity),
+                                                                          first.method, horizon, forecastPool);
+        for (size_t i : group.second) {
+            size_t slot = slots[parsed[i].country];
+            models[i] = results[slot];
+            lastPeriods[i] = firstPeriods[slot] + static_cast<int>(series[slot].size()) - 1;
+        }
+    }
+
+    // Everything else only reads the table, the rollup and the thread-safe caches:
+    // workers take queries one at a time, each writing to its own buffer
+    std::atomic<size_t> nextQuery(0);
+    unsigned workers = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workerCount, count)));
+    queryWorkers = (workers > 1) ? 1 : workerCount;
+    Parallel::run(workers, [&](unsigned) {
+        for (size_t i = nextQuery++; i < count; i = nextQuery++) {
+            BatchQuery::Result result;
+            if (errors[i].empty() && runBatchQuery(parsed[i], models[i], lastPeriods[i], result, errors[i])) {
+                outputs[i] = parsed[i].formatText(result);
+            }
+        }
+    });
+    queryWorkers = workerCount;
+
+    // Results in query order, blocks separated by a blank line, written at once
+    std::string results;
+    size_t failed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!errors[i].empty()) {
+            std::cerr << "Error: Query " << i + 1 << " (" << queries[i] << "): " << errors[i] << "." << std::endl;
+            ++failed;
+            continue;
+        }
+        if (!results.empty()) {
+            results += '\n';
+        }
+        results += outputs[i];
+    }
+    std::cout << results << std::flush;
+    return failed;
+}
+
+// ─────────────────────────────────────────────
+// Batch Mode: Answer One Query
+// ─────────────────────────────────────────────
+bool MerkelMain::runBatchQuery(const BatchQuery& query, const Forecaster::Result& model, int lastPeriod,
+                               BatchQuery::Result& result, std::string& error)
+{
+    int column = weatherTable.schema().columnIndex(query.country, WeatherSchema::TEMPERATURE);
+    WeatherRollup::Granularity granularity = query.granularity;
+
+    switch (query.kind) {
+        case BatchQuery::Kind::Candles: {
+            std::vector<Candlestick> candles = computeCandlestickDataForCountry(query.country, granularity);
+            if (candles.empty()) {
+                error = "no candlestick data";
+                return false;
+            }
+            result.columns = {"Date", "Open", "High", "Low", "Close"};
+            for (const Candlestick& candle : candles) {
+                result.labels.push_back(candle.label());
+                result.values.insert(result.values.end(), {candle.open, candle.high, candle.low, candle.close});
+            }
+            break;
+        }
+        case BatchQuery::Kind::Histogram: {
+            std::vector<std::pair<int, double>> periodData =
+                collectPeriodValues(query.country, column, granularity, query.dataType, query.percentile);
+            if (periodData.empty()) {
+                error = "no data";
+                return false;
+            }
+            result.columns = {"Period", dataTypeName(query.dataType, query.percentile)};
+            for (const auto& point : periodData) {
+                result.labels.push_back(WeatherRollup::periodLabel(granularity, point.first));
+                result.values.push_back(point.second);
+            }
+            break;
+        }
+        case BatchQuery::Kind::Forecast: {
+            std::ostringstream description;
+            if (query.linear) {
+                std::vector<std::pair<int, double>> dataPoints = collectPeriodValues(query.country, column, granularity, 1);
+                RegressionEngine::Fit fit = regressionFor(granularity).fit(static_cast<size_t>(column));
+                if (dataPoints.size() < 2 || !fit.valid) {
+                    error = "not enough data points for regression analysis";
+                    return false;
+                }
+                description << "Y = " << fit.slope << " * X + " << fit.intercept;
+                lastPeriod = dataPoints.back().first;
+                for (int i = 1; i <= query.periods; ++i) {
+                    result.values.push_back(fit.slope * (lastPeriod + i) + fit.intercept);
+                }
+            } else {
+                if (!model.valid) {
+                    error = std::string("could not fit a ") + Forecaster::methodName(query.method) + " model";
+                    return false;
+                }
+                description << model.model << " (RMSE " << std::fixed << std::setprecision(3) << model.rmse
+                            << ", AIC " << model.aic << ")";
+                result.values.assign(model.forecast.begin(), model.forecast.begin() + query.periods);
+            }
+            result.model = description.str();
+            result.columns = {"Period", "Forecast"};
+            for (int i = 1; i <= query.periods; ++i) {
+                result.labels.push_back(WeatherRollup::periodLabel(granularity, lastPeriod + i));
+            }
+            break;
+        }
+        case BatchQuery::Kind::Window: {
+            RangeIndex::Stats stats = windowStats(query.country, column, query.from, query.to);
+            if (stats.count == 0) {
+                error = "no temperature readings in this window";
+                return false;
+            }
+            result.columns = {"Count", "Open", "High", "Low", "Close", "Mean"};
+            result.labels.push_back(std::to_string(stats.count));
+            result.values = {stats.open, stats.high, stats.low, stats.close, stats.mean};
+            break;
+        }
+    }
+    return true;
+}
+
+// ─────────────────────────────────────────────
+// Server Mode: Answer One Request Line as JSON
+// ─────────────────────────────────────────────
+std::string MerkelMain::answerQuery(const std::string& line)
+{
+    // A failing request (e.g. out of memory) is answered as an error; it must not end the server
+    try {
+        BatchQuery query;
+        std::string error;
+        if (!BatchQuery::parse(line, query, error)) {
+            return BatchQuery::formatError(line, error);
+        }
+        int column = weatherTable.schema().columnIndex(query.country, WeatherSchema::TEMPERATURE);
+        if (column == -1) {
+            return BatchQuery::formatError(query.text, "country code " + query.country + " not found in headers");
+        }
+
+        // Model fits run on the shared pool, alongside those of other clients
+        Forecaster::Result model;
+        int lastPeriod = 0;
+        if (query.kind == BatchQuery::Kind::Forecast && !query.linear) {
+            int firstPeriod = 0;
+            std::vector<double> values = forecastSeries(query.country, column, query.granularity, firstPeriod);
+            model = Forecaster::forecast(values, Forecaster::seasonLength(query.granularity), query.method,
+                                         query.periods, forecastPool);
+            lastPeriod = firstPeriod + static_cast<int>(values.size()) - 1;
+        }
+
+        BatchQuery::Result result;
+        if (!runBatchQuery(query, model, lastPeriod, result, error)) {
+            return BatchQuery::formatError(query.text, error);
+        }
+        return query.formatJSON(result);
+    }
+    catch (const std::exception& e) {
+        return BatchQuery::formatError(line, std::string("internal error: ") + e.what());
+    }
+}
+
+// ─────────────────────────────────────────────
+// Server Mode: Serve Queries over a Unix Socket
+// ─────────────────────────────────────────────
+bool MerkelMain::serve(const std::string& socketPath, unsigned threads)
+{
+    if (weatherTable.empty()) {
+        std::cerr << "Error: No CSV data available to serve." << std::endl;
+        return false;
+    }
+
+    // Requests already run side by side on the server's workers; one request never adds
+    // threads of its own (forecast fits share forecastPool)
+    queryWorkers = 1;
+
+    // Everything built on first use is built now, so requests only read shared state
+    for (WeatherRollup::Granularity granularity : {WeatherRollup::Granularity::Year, WeatherRollup::Granularity::Month,
+                                                   WeatherRollup::Granularity::Week, WeatherRollup::Granularity::Day}) {
+        regressionFor(granularity);
+    }
+
+    QueryServer server(socketPath, threads, [this](const std::string& line) { return answerQuery(line); });
+    if (!server.start()) {
+        return false;
+    }
+    std::cerr << "Serving " << weatherTable.rowCount() << " rows on " << socketPath << " with "
+              << server.threadCount() << " threads (Ctrl-C to stop)" << std::endl;
+    server.run();
+    std::cerr << "Served " << server.requests() << " requests." << std::endl;
+    return true;
+}
@@ -0,0 +1,164 @@
+#include "NumberParser.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    // Powers of ten that are exactly representable as doubles
+    const double EXACT_POWERS_OF_TEN[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const uint64_t MAX_EXACT_MANTISSA = uint64_t(1) << 53;
+
+    std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    inline bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * @brief Slow path for syntactically valid numbers outside the exact range
+     */
+    bool parseWithStrtod(std::string_view text, double& value)
+    {
+        char buffer[128];
+        if (text.size() >= sizeof(buffer)) {
+            return false;
+        }
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+        char* end = nullptr;
+        value = std::strtod(buffer, &end);
+        return end == buffer + text.size() && !std::isinf(value); // Overflow is not a reading
+    }
+}
+
+// Function to parse a decimal number such as "-12.345" or "1.5e3"
+NumberParser::Result NumberParser::parseDouble(std::string_view text, double& value) {
+    text = trim(text);
+    if (text.empty()) {
+        return Result::Empty;
+    }
+
+    size_t i = 0;
+    bool negative = false;
+    if (text[i] == '-' || text[i] == '+') {
+        negative = (text[i] == '-');
+        ++i;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;          // Decimal exponent applied to the mantissa
+    bool anyDigits = false;
+    bool truncated = false;    // More than 19 significant digits
+
+    // Integer part
+    for (; i < text.size() && isDigit(text[i]); ++i) {
+        anyDigits = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+            if (mantissa != 0) {
+                ++significantDigits;
+            }
+        } else {
+            ++exponent;
+            truncated = true;
+        }
+    }
+    // Fraction part
+    if (i < text.size() && text[i] == '.') {
+        ++i;
+        for (; i < text.size() && isDigit(text[i]); ++i) {
+            anyDigits = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+                if (mantissa != 0) {
+                    ++significantDigits;
+                }
+                --exponent;
+            } else {
+                truncated = true;
+            }
+        }
+    }
+    if (!anyDigits) {
+        return Result::Invalid;
+    }
+    // Exponent part
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        ++i;
+        bool negativeExponent = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            negativeExponent = (text[i] == '-');
+            ++i;
+        }
+        if (i >= text.size() || !isDigit(text[i])) {
+            return Result::Invalid;
+        }
+        int explicitExponent = 0;
+        for (; i < text.size() && isDigit(text[i]); ++i) {
+            if (explicitExponent < 100000) {
+                explicitExponent = explicitExponent * 10 + (text[i] - '0');
+            }
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    if (i != text.size()) {
+        return Result::Invalid; // Trailing garbage
+    }
+
+    // Exact fast path: both operands are exact, so one IEEE operation rounds correctly
+    if (!truncated && mantissa <= MAX_EXACT_MANTISSA && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / EXACT_POWERS_OF_TEN[-exponent]
+                              : result * EXACT_POWERS_OF_TEN[exponent];
+        value = negative ? -result : result;
+        return Result::Ok;
+    }
+
+    return parseWithStrtod(text, value) ? Result::Ok : Result::Invalid;
+}
+
+// Function to parse a whole cell as a signed integer
+NumberParser::Result NumberParser::parseInt(std::string_view text, int64_t& value) {
+    text = trim(text);
+    if (text.empty()) {
+        return Result::Empty;
+    }
+
+    size_t i = 0;
+    bool negative = false;
+    if (text[i] == '-' || text[i] == '+') {
+        negative = (text[i] == '-');
+        ++i;
+    }
+    if (i >= text.size()) {
+        return Result::Invalid;
+    }
+
+    uint64_t magnitude = 0;
+    for (; i < text.size(); ++i) {
+        if (!isDigit(text[i])) {
+            return Result::Invalid;
+        }
+        uint64_t next = magnitude * 10 + static_cast<uint64_t>(text[i] - '0');
+        if (next / 10 != magnitude || next > uint64_t(INT64_MAX) + (negative ? 1 : 0)) {
+            return Result::Invalid; // Overflow
+        }
+        magnitude = next;
+    }
+    value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    return Result::Ok;
+}
@@ -0,0 +1,63 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+unsigned Parallel::workerCount(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+void Parallel::run(unsigned workers, const std::function<void(unsigned)>& task) {
+    if (workers <= 1) {
+        task(0);
+        return;
+    }
+    // An exception is caught on the thread that threw it; the first one is rethrown once all have joined
+    std::vector<std::exception_ptr> errors(workers);
+    auto guarded = [&task, &errors](unsigned w) {
+        try {
+            task(w);
+        } catch (...) {
+            errors[w] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    unsigned started = 1;
+    try {
+        for (; started < workers; ++started) {
+            threads.emplace_back(guarded, started);
+        }
+    } catch (const std::system_error&) {
+        // Out of threads: the workers that could not start run on the calling thread below
+    }
+    guarded(0);
+    for (unsigned w = started; w < workers; ++w) {
+        guarded(w);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+std::vector<std::pair<size_t, size_t>> Parallel::splitRange(size_t count, unsigned parts) {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (parts == 0) {
+        parts = 1;
+    }
+    size_t step = (count + parts - 1) / parts;
+    for (size_t begin = 0; begin < count; begin += step) {
+        ranges.emplace_back(begin, std::min(count, begin + step));
+    }
+    return ranges;
+}
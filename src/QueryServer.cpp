@@ -0,0 +1,366 @@
+#include "QueryServer.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // Interval at which blocked waits look at the stop flag
+    const int POLL_INTERVAL_MS = 200;
+    const unsigned DEFAULT_THREADS = 8;
+
+    // Set by SIGINT/SIGTERM; lock-free, so safe in a handler and in the worker threads
+    std::atomic<bool> signalled(false);
+
+    void onSignal(int)
+    {
+        signalled.store(true);
+    }
+}
+
+QueryServer::QueryServer(const std::string& socketPath_, unsigned threads_, Handler handler_)
+    : socketPath(socketPath_), threads(threads_ == 0 ? DEFAULT_THREADS : threads_), handler(std::move(handler_)),
+      listener(-1), stopRequested(false), requestCount(0), wakeRead(-1), wakeWrite(-1) {}
+
+QueryServer::~QueryServer() {
+    stop();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    if (listener != -1) {
+        ::close(listener);
+        ::unlink(socketPath.c_str());
+    }
+    if (wakeRead != -1) {
+        ::close(wakeRead);
+        ::close(wakeWrite);
+    }
+}
+
+bool QueryServer::start() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path must be 1 to " << sizeof(address.sun_path) - 1 << " characters." << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == -1) {
+        std::cerr << "Error: Could not create a socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // A socket file left by a previous run would make bind fail
+    ::unlink(socketPath.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        ::listen(listener, SOMAXCONN) == -1) {
+        std::cerr << "Error: Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(listener);
+        listener = -1;
+        return false;
+    }
+    // Workers write to this pipe to interrupt the poll loop's wait
+    int wakePipe[2];
+    if (::pipe(wakePipe) == -1) {
+        std::cerr << "Error: Could not create a pipe: " << std::strerror(errno) << std::endl;
+        ::close(listener);
+        listener = -1;
+        return false;
+    }
+    wakeRead = wakePipe[0];
+    wakeWrite = wakePipe[1];
+    ::fcntl(wakeRead, F_SETFL, O_NONBLOCK);
+    ::fcntl(wakeWrite, F_SETFL, O_NONBLOCK);
+    return true;
+}
+
+// Function to accept connections, read their requests and queue each line for the workers
+void QueryServer::run() {
+    if (listener == -1) {
+        return;
+    }
+    signalled.store(false);
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    struct sigaction oldInterrupt;
+    struct sigaction oldTerminate;
+    ::sigaction(SIGINT, &action, &oldInterrupt);
+    ::sigaction(SIGTERM, &action, &oldTerminate);
+
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&QueryServer::work, this);
+    }
+
+    std::vector<pollfd> watched;
+    while (!stopping()) {
+        reapClosed();
+        watched.clear();
+        watched.push_back(pollfd{listener, POLLIN, 0});
+        watched.push_back(pollfd{wakeRead, POLLIN, 0});
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& entry : connections) {
+                const Connection& connection = entry.second;
+                short events = 0;
+                // A connection with a full backlog is left unread until the workers catch up
+                if (!connection.closing && connection.lines.size() < MAX_QUEUED_LINES) {
+                    events |= POLLIN;
+                }
+                if (!connection.broken && !connection.output.empty()) {
+                    events |= POLLOUT;
+                }
+                if (events != 0) {
+                    watched.push_back(pollfd{entry.first, events, 0});
+                }
+            }
+        }
+        // Signals cannot write to the pipe, so the stop flag is also checked on a timer
+        if (::poll(watched.data(), watched.size(), POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        if (watched[1].revents != 0) {
+            char drain[64];
+            while (::read(wakeRead, drain, sizeof(drain)) > 0) {
+            }
+        }
+        for (size_t i = 2; i < watched.size(); ++i) {
+            if (watched[i].revents == 0) {
+                continue;
+            }
+            if (watched[i].events & POLLOUT) {
+                writeClient(watched[i].fd);
+            }
+            if (watched[i].events & POLLIN) {
+                readClient(watched[i].fd);
+            }
+        }
+        if (watched[0].revents != 0) {
+            int client = ::accept(listener, nullptr, nullptr);
+            if (client != -1) {
+                // Non-blocking, so a client that stops reading can never hold up a worker
+                ::fcntl(client, F_SETFL, O_NONBLOCK);
+                std::lock_guard<std::mutex> lock(mutex);
+                connections[client];
+            } // Otherwise EINTR, or a client that gave up before being accepted
+        }
+    }
+
+    stop();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    for (const auto& entry : connections) {
+        ::close(entry.first);
+    }
+    connections.clear();
+    pending.clear();
+    ::sigaction(SIGINT, &oldInterrupt, nullptr);
+    ::sigaction(SIGTERM, &oldTerminate, nullptr);
+}
+
+void QueryServer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    ready.notify_all();
+}
+
+bool QueryServer::stopping() const {
+    return stopRequested.load() || signalled.load();
+}
+
+void QueryServer::wake() {
+    char byte = 0;
+    // A full pipe already guarantees a wake-up, so a failed write needs no handling
+    if (::write(wakeWrite, &byte, 1) < 0) {
+        return;
+    }
+}
+
+// Function to split what a client sent into request lines and queue the connection for a worker
+void QueryServer::readClient(int client) {
+    char chunk[16 * 1024];
+    ssize_t received = ::recv(client, chunk, sizeof(chunk), MSG_DONTWAIT);
+    if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = connections.find(client);
+        if (found == connections.end()) {
+            return;
+        }
+        Connection& connection = found->second;
+        if (received <= 0) {
+            // Closed by the client, or reset; lines already received are still answered
+            connection.closing = true;
+            return;
+        }
+        connection.input.append(chunk, static_cast<size_t>(received));
+
+        size_t start = 0;
+        size_t end = 0;
+        while ((end = connection.input.find('\n', start)) != std::string::npos) {
+            std::string line = connection.input.substr(start, end - start);
+            start = end + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                connection.lines.push_back(std::move(line));
+            }
+        }
+        connection.input.erase(0, start);
+        if (connection.input.size() > MAX_LINE_BYTES) {
+            connection.closing = true; // No newline in sight; not a client of this protocol
+        }
+        queued = schedule(client, connection);
+    }
+    if (queued) {
+        ready.notify_one();
+    }
+}
+
+// Function to send what the socket takes of a connection's unsent responses
+void QueryServer::writeClient(int client) {
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = connections.find(client);
+        if (found == connections.end()) {
+            return;
+        }
+        flush(client, found->second);
+        queued = schedule(client, found->second);
+    }
+    if (queued) {
+        ready.notify_one();
+    }
+}
+
+void QueryServer::flush(int client, Connection& connection) {
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t written = ::send(client, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break; // Socket buffer full; the poll loop sends the rest on POLLOUT
+        }
+        if (written <= 0) {
+            // Peer gone: nothing more will be read or answered on this connection
+            connection.broken = true;
+            connection.closing = true;
+            connection.lines.clear();
+            connection.output.clear();
+            return;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    connection.output.erase(0, sent);
+}
+
+bool QueryServer::schedule(int client, Connection& connection) {
+    if (connection.busy || connection.broken || connection.lines.empty() ||
+        connection.output.size() >= MAX_UNSENT_BYTES) {
+        return false;
+    }
+    connection.busy = true;
+    pending.push_back(client);
+    return true;
+}
+
+bool QueryServer::finished(const Connection& connection) {
+    return !connection.busy &&
+           (connection.broken || (connection.closing && connection.lines.empty() && connection.output.empty()));
+}
+
+void QueryServer::reapClosed() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto entry = connections.begin(); entry != connections.end();) {
+        if (finished(entry->second)) {
+            ::close(entry->first);
+            entry = connections.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
+
+// Function to answer one request line per job, requeueing the connection while it has more
+void QueryServer::work() {
+    while (true) {
+        int client = -1;
+        std::string line;
+        bool resumeReading = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Signals cannot notify, so the stop flag is also checked on a timer
+            ready.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS),
+                           [this] { return stopping() || !pending.empty(); });
+            if (stopping()) {
+                return;
+            }
+            if (pending.empty()) {
+                continue;
+            }
+            client = pending.front();
+            pending.pop_front();
+            Connection& connection = connections.at(client);
+            if (connection.lines.empty()) {
+                // A send failed after this job was queued; hand the connection back to be closed
+                connection.busy = false;
+                lock.unlock();
+                wake();
+                continue;
+            }
+            line = std::move(connection.lines.front());
+            connection.lines.pop_front();
+            resumeReading = (connection.lines.size() == MAX_QUEUED_LINES - 1);
+        }
+        if (resumeReading) {
+            wake();
+        }
+
+        std::string response = handler(line);
+        ++requestCount;
+
+        bool wakeLoop = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // The connection is busy, so the poll loop has neither closed nor erased it
+            Connection& connection = connections.at(client);
+            if (!connection.broken) {
+                connection.output += response;
+                connection.output += '\n';
+                flush(client, connection);
+            }
+            connection.busy = false;
+            // Back of the queue, so one pipelining client cannot starve the others
+            schedule(client, connection);
+            // The poll loop must watch for POLLOUT, or close a finished connection
+            wakeLoop = !connection.output.empty() || finished(connection);
+        }
+        if (wakeLoop) {
+            wake();
+        }
+    }
+}
@@ -0,0 +1,199 @@
+#include "RangeIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "ReduceKernels.h"
+
+namespace {
+    /**
+     * @brief Fold one row into window stats (used by the row-scan fallback)
+     */
+    void addValue(RangeIndex::Stats& stats, double& sum, double value)
+    {
+        if (stats.count == 0) {
+            stats.open = value;
+        }
+        stats.close = value;
+        sum += value;
+        ++stats.count;
+        stats.high = std::max(stats.high, value);
+        stats.low = std::min(stats.low, value);
+    }
+
+    /**
+     * @brief Largest l with 2^l <= n (n > 0)
+     */
+    size_t floorLog2(size_t n)
+    {
+        size_t level = 0;
+        while ((static_cast<size_t>(2) << level) <= n) {
+            ++level;
+        }
+        return level;
+    }
+}
+
+// ─────────────────────────────────────────────
+// RangeIndex
+// ─────────────────────────────────────────────
+RangeIndex::Stats::Stats()
+    : count(0),
+      open(std::numeric_limits<double>::quiet_NaN()),
+      high(std::numeric_limits<double>::lowest()),
+      low(std::numeric_limits<double>::max()),
+      close(std::numeric_limits<double>::quiet_NaN()),
+      mean(std::numeric_limits<double>::quiet_NaN()) {}
+
+RangeIndex::RangeIndex()
+    : values(nullptr), rows(0) {}
+
+// Function to build the prefix arrays and the block sparse tables
+void RangeIndex::build(const double* values_, size_t count) {
+    values = values_;
+    rows = count;
+
+    prefixSum.assign(rows + 1, 0.0);
+    prefixCount.assign(rows + 1, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        bool present = !std::isnan(values[i]);
+        prefixSum[i + 1] = prefixSum[i] + (present ? values[i] : 0.0);
+        prefixCount[i + 1] = prefixCount[i] + (present ? 1 : 0);
+    }
+
+    // Level 0: min/max of each block, ignoring missing values
+    size_t blocks = (rows + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    minTable.assign(1, std::vector<double>(blocks));
+    maxTable.assign(1, std::vector<double>(blocks));
+    for (size_t b = 0; b < blocks; ++b) {
+        size_t begin = b * BLOCK_SIZE;
+        size_t length = (rows - begin < BLOCK_SIZE) ? rows - begin : BLOCK_SIZE;
+        ReduceKernels::Summary summary;
+        ReduceKernels::reduce(values + begin, length, summary);
+        minTable[0][b] = summary.min;
+        maxTable[0][b] = summary.max;
+    }
+
+    // Level l covers 2^l blocks and is combined from two halves of level l - 1
+    for (size_t level = 1; (static_cast<size_t>(1) << level) <= blocks; ++level) {
+        size_t half = static_cast<size_t>(1) << (level - 1);
+        size_t width = blocks - (static_cast<size_t>(1) << level) + 1;
+        const std::vector<double>& lowerMin = minTable[level - 1];
+        const std::vector<double>& lowerMax = maxTable[level - 1];
+        std::vector<double> levelMin(width);
+        std::vector<double> levelMax(width);
+        for (size_t b = 0; b < width; ++b) {
+            levelMin[b] = std::min(lowerMin[b], lowerMin[b + half]);
+            levelMax[b] = std::max(lowerMax[b], lowerMax[b + half]);
+        }
+        minTable.push_back(std::move(levelMin));
+        maxTable.push_back(std::move(levelMax));
+    }
+}
+
+// Function to summarise rows [begin, end) in O(log n)
+RangeIndex::Stats RangeIndex::query(size_t begin, size_t end) const {
+    Stats stats;
+    end = std::min(end, rows);
+    if (begin >= end) {
+        return stats;
+    }
+    stats.count = prefixCount[end] - prefixCount[begin];
+    if (stats.count == 0) {
+        return stats;
+    }
+    stats.mean = (prefixSum[end] - prefixSum[begin]) / static_cast<double>(stats.count);
+
+    // First value: the row where the prefix count first rises; last value: the row before it stops rising
+    const uint32_t* counts = prefixCount.data();
+    size_t first = static_cast<size_t>(std::upper_bound(counts + begin + 1, counts + end + 1, counts[begin]) - counts) - 1;
+    size_t last = static_cast<size_t>(std::lower_bound(counts + begin, counts + end + 1, counts[end]) - counts) - 1;
+    stats.open = values[first];
+    stats.close = values[last];
+
+    // Whole blocks through the sparse table, the partial blocks at either end through the kernels
+    size_t firstBlock = (begin + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    size_t endBlock = end / BLOCK_SIZE;
+    ReduceKernels::Summary edges;
+    if (firstBlock < endBlock) {
+        size_t level = floorLog2(endBlock - firstBlock);
+        size_t other = endBlock - (static_cast<size_t>(1) << level);
+        edges.min = std::min(minTable[level][firstBlock], minTable[level][other]);
+        edges.max = std::max(maxTable[level][firstBlock], maxTable[level][other]);
+        ReduceKernels::reduce(values + begin, firstBlock * BLOCK_SIZE - begin, edges);
+        ReduceKernels::reduce(values + endBlock * BLOCK_SIZE, end - endBlock * BLOCK_SIZE, edges);
+    } else {
+        ReduceKernels::reduce(values + begin, end - begin, edges);
+    }
+    stats.low = edges.min;
+    stats.high = edges.max;
+    return stats;
+}
+
+// ─────────────────────────────────────────────
+// WindowIndex
+// ─────────────────────────────────────────────
+WindowIndex::WindowIndex()
+    : table(nullptr), sorted(false) {}
+
+void WindowIndex::attach(const WeatherTable& table_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    table = &table_;
+    sorted = table->timestampsAscending();
+    columns.clear();
+    columns.resize(table->columnCount());
+}
+
+void WindowIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    table = nullptr;
+    sorted = false;
+    columns.clear();
+}
+
+std::pair<size_t, size_t> WindowIndex::rowRange(int64_t from, int64_t to) const {
+    if (table == nullptr || from >= to) {
+        return { 0, 0 };
+    }
+    const int64_t* begin = table->timestamps();
+    const int64_t* end = begin + table->rowCount();
+    const int64_t* first = std::lower_bound(begin, end, from);
+    const int64_t* last = std::lower_bound(first, end, to);
+    return { static_cast<size_t>(first - begin), static_cast<size_t>(last - begin) };
+}
+
+const RangeIndex& WindowIndex::columnIndex(size_t column) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<RangeIndex>& index = columns[column];
+    if (!index) {
+        index.reset(new RangeIndex());
+        index->build(table->column(column), table->rowCount());
+    }
+    return *index;
+}
+
+// Function to answer a time-window query for one column
+RangeIndex::Stats WindowIndex::query(size_t column, int64_t from, int64_t to) const {
+    if (table == nullptr || column >= table->columnCount()) {
+        return RangeIndex::Stats();
+    }
+
+    if (sorted) {
+        std::pair<size_t, size_t> rowsInWindow = rowRange(from, to);
+        return columnIndex(column).query(rowsInWindow.first, rowsInWindow.second);
+    }
+
+    // Unordered timestamps: scan every row
+    RangeIndex::Stats stats;
+    double sum = 0.0;
+    const int64_t* timestamps = table->timestamps();
+    const double* values = table->column(column);
+    for (size_t i = 0; i < table->rowCount(); ++i) {
+        if (timestamps[i] >= from && timestamps[i] < to && !std::isnan(values[i])) {
+            addValue(stats, sum, values[i]);
+        }
+    }
+    if (stats.count > 0) {
+        stats.mean = sum / static_cast<double>(stats.count);
+    }
+    return stats;
+}
@@ -0,0 +1,197 @@
+#include "ReduceKernels.h"
+#include <cmath>
+#include <limits>
+#include "CpuFeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REDUCEKERNELS_X86 1
+#endif
+
+namespace {
+    /**
+     * @brief One value at a time, skipping NaN
+     */
+    void reduceScalar(const double* values, size_t length, ReduceKernels::Summary& summary)
+    {
+        for (size_t i = 0; i < length; ++i) {
+            double value = values[i];
+            if (std::isnan(value)) {
+                continue;
+            }
+            summary.sum += value;
+            ++summary.count;
+            if (value < summary.min) {
+                summary.min = value;
+            }
+            if (value > summary.max) {
+                summary.max = value;
+            }
+        }
+    }
+
+    /**
+     * @brief Plain multiply-add loop
+     */
+    double dotScalar(const double* a, const double* b, size_t length)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < length; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+#ifdef REDUCEKERNELS_X86
+    /**
+     * @brief Horizontal sum / min / max of a 4-lane register
+     */
+    __attribute__((target("avx2")))
+    double horizontalSum(__m256d v)
+    {
+        __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    __attribute__((target("avx2")))
+    double horizontalMin(__m256d v)
+    {
+        __m128d pair = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_min_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    __attribute__((target("avx2")))
+    double horizontalMax(__m256d v)
+    {
+        __m128d pair = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_max_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    __attribute__((target("avx2")))
+    void reduceAVX2(const double* values, size_t length, ReduceKernels::Summary& summary)
+    {
+        const __m256d plusInf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+        const __m256d minusInf = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+        // Two independent accumulator sets hide the add/min/max latency
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d min0 = plusInf;
+        __m256d min1 = plusInf;
+        __m256d max0 = minusInf;
+        __m256d max1 = minusInf;
+        size_t count = 0;
+
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            __m256d a = _mm256_loadu_pd(values + i);
+            __m256d b = _mm256_loadu_pd(values + i + 4);
+            __m256d presentA = _mm256_cmp_pd(a, a, _CMP_ORD_Q); // All ones where not NaN
+            __m256d presentB = _mm256_cmp_pd(b, b, _CMP_ORD_Q);
+            sum0 = _mm256_add_pd(sum0, _mm256_and_pd(a, presentA));
+            sum1 = _mm256_add_pd(sum1, _mm256_and_pd(b, presentB));
+            min0 = _mm256_min_pd(min0, _mm256_blendv_pd(plusInf, a, presentA));
+            min1 = _mm256_min_pd(min1, _mm256_blendv_pd(plusInf, b, presentB));
+            max0 = _mm256_max_pd(max0, _mm256_blendv_pd(minusInf, a, presentA));
+            max1 = _mm256_max_pd(max1, _mm256_blendv_pd(minusInf, b, presentB));
+            count += static_cast<size_t>(__builtin_popcount(_mm256_movemask_pd(presentA)) +
+                                         __builtin_popcount(_mm256_movemask_pd(presentB)));
+        }
+
+        ReduceKernels::Summary tail;
+        reduceScalar(values + i, length - i, tail);
+
+        count += tail.count;
+        if (count == 0) {
+            return;
+        }
+        summary.sum += horizontalSum(_mm256_add_pd(sum0, sum1)) + tail.sum;
+        summary.count += count;
+        double low = std::fmin(horizontalMin(_mm256_min_pd(min0, min1)), tail.min);
+        double high = std::fmax(horizontalMax(_mm256_max_pd(max0, max1)), tail.max);
+        if (low < summary.min) {
+            summary.min = low;
+        }
+        if (high > summary.max) {
+            summary.max = high;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    double dotAVX2(const double* a, const double* b, size_t length)
+    {
+        // Two accumulators hide the add latency
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+        }
+        return horizontalSum(_mm256_add_pd(sum0, sum1)) + dotScalar(a + i, b + i, length - i);
+    }
+#endif
+}
+
+ReduceKernels::Summary::Summary()
+    : sum(0.0), count(0),
+      min(std::numeric_limits<double>::max()),
+      max(std::numeric_limits<double>::lowest()) {}
+
+ReduceKernels::Implementation ReduceKernels::bestImplementation() {
+    static const Implementation best =
+        CpuFeatures::hasAVX2() ? Implementation::AVX2 : Implementation::Scalar;
+    return best;
+}
+
+const char* ReduceKernels::implementationName(Implementation impl) {
+    return impl == Implementation::AVX2 ? "avx2" : "scalar";
+}
+
+void ReduceKernels::reduce(const double* values, size_t length, Summary& summary) {
+    reduce(bestImplementation(), values, length, summary);
+}
+
+void ReduceKernels::reduce(Implementation impl, const double* values, size_t length, Summary& summary) {
+#ifdef REDUCEKERNELS_X86
+    if (impl == Implementation::AVX2 && CpuFeatures::hasAVX2()) {
+        reduceAVX2(values, length, summary);
+        return;
+    }
+#else
+    (void)impl;
+#endif
+    reduceScalar(values, length, summary);
+}
+
+double ReduceKernels::dot(const double* a, const double* b, size_t length) {
+    return dot(bestImplementation(), a, b, length);
+}
+
+double ReduceKernels::dot(Implementation impl, const double* a, const double* b, size_t length) {
+#ifdef REDUCEKERNELS_X86
+    if (impl == Implementation::AVX2 && CpuFeatures::hasAVX2()) {
+        return dotAVX2(a, b, length);
+    }
+#else
+    (void)impl;
+#endif
+    return dotScalar(a, b, length);
+}
+
+size_t ReduceKernels::firstPresent(const double* values, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (!std::isnan(values[i])) {
+            return i;
+        }
+    }
+    return length;
+}
+
+size_t ReduceKernels::lastPresent(const double* values, size_t length) {
+    for (size_t i = length; i > 0; --i) {
+        if (!std::isnan(values[i - 1])) {
+            return i - 1;
+        }
+    }
+    return length;
+}
@@ -0,0 +1,211 @@
+#include "RegressionEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Parallel.h"
+
+// ─────────────────────────────────────────────
+// Moments
+// ─────────────────────────────────────────────
+RegressionEngine::Moments::Moments()
+    : n(0.0), meanX(0.0), meanY(0.0), cxx(0.0), cxy(0.0) {}
+
+void RegressionEngine::Moments::add(double x, double y) {
+    n += 1.0;
+    double dx = x - meanX;
+    meanX += dx / n;
+    meanY += (y - meanY) / n;
+    cxx += dx * (x - meanX);
+    cxy += dx * (y - meanY);
+}
+
+void RegressionEngine::Moments::remove(double x, double y) {
+    if (n <= 1.0) {
+        *this = Moments();
+        return;
+    }
+    // Undo add(): recover the means before x was added, then take back its co-moment terms
+    double previousMeanX = (n * meanX - x) / (n - 1.0);
+    double previousMeanY = (n * meanY - y) / (n - 1.0);
+    double dx = x - previousMeanX;
+    cxx -= dx * (x - meanX);
+    cxy -= dx * (y - meanY);
+    meanX = previousMeanX;
+    meanY = previousMeanY;
+    n -= 1.0;
+}
+
+void RegressionEngine::Moments::merge(const Moments& other) {
+    if (other.n == 0.0) {
+        return;
+    }
+    if (n == 0.0) {
+        *this = other;
+        return;
+    }
+    // Chan et al.: co-moments of the union from the two parts and the gap between their means
+    double total = n + other.n;
+    double dx = other.meanX - meanX;
+    double dy = other.meanY - meanY;
+    double weight = n * other.n / total;
+    cxx += other.cxx + dx * dx * weight;
+    cxy += other.cxy + dx * dy * weight;
+    meanX += dx * other.n / total;
+    meanY += dy * other.n / total;
+    n = total;
+}
+
+bool RegressionEngine::Moments::fit(double& slope, double& intercept) const {
+    if (n < 2.0 || cxx <= 0.0) {
+        return false;
+    }
+    slope = cxy / cxx;
+    intercept = meanY - slope * meanX;
+    return true;
+}
+
+// ─────────────────────────────────────────────
+// RegressionEngine
+// ─────────────────────────────────────────────
+RegressionEngine::Fit::Fit()
+    : valid(false), slope(0.0), intercept(0.0), points(0), lastPeriod(0) {}
+
+RegressionEngine::RegressionEngine()
+    : level(WeatherRollup::Granularity::Year), firstPeriod(0), workers(0) {}
+
+void RegressionEngine::clear() {
+    series.clear();
+    firstPeriod = 0;
+}
+
+// Function to fit every column in one pass over the periods
+void RegressionEngine::build(const WeatherRollup& rollup, const std::vector<size_t>& columns,
+                             WeatherRollup::Granularity granularity, unsigned workers_) {
+    clear();
+    level = granularity;
+    workers = workers_;
+    firstPeriod = rollup.firstPeriod(granularity);
+    size_t periods = rollup.bucketCount(granularity);
+
+    std::vector<const WeatherRollup::Bucket*> buckets;
+    for (size_t column : columns) {
+        const WeatherRollup::Bucket* columnBuckets = rollup.buckets(granularity, column);
+        if (columnBuckets != nullptr) {
+            series.push_back({ column, Moments(), std::vector<double>(periods) });
+            buckets.push_back(columnBuckets);
+        }
+    }
+    size_t count = series.size();
+    if (count == 0 || periods == 0) {
+        return;
+    }
+
+    // Each worker takes a block of periods; within it the series are the inner loop,
+    // updated side by side from flat arrays with no branch on missing periods
+    std::vector<std::pair<size_t, size_t>> ranges = Parallel::splitRange(periods, Parallel::workerCount(workers));
+    std::vector<std::vector<Moments>> partial(ranges.size());
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        std::vector<double> n(count, 0.0), meanX(count, 0.0), meanY(count, 0.0), cxx(count, 0.0), cxy(count, 0.0);
+        for (size_t i = ranges[worker].first; i < ranges[worker].second; ++i) {
+            double x = static_cast<double>(firstPeriod + static_cast<int64_t>(i));
+            for (size_t s = 0; s < count; ++s) {
+                const WeatherRollup::Bucket& bucket = buckets[s][i];
+                bool present = bucket.count > 0;
+                double w = present ? 1.0 : 0.0;
+                double y = present ? bucket.mean() : 0.0;
+                series[s].values[i] = present ? y : std::numeric_limits<double>::quiet_NaN();
+
+                double total = n[s] + w;
+                double step = w / std::max(total, 1.0); // 0 for a missing period
+                double dx = x - meanX[s];
+                meanX[s] += dx * step;
+                meanY[s] += (y - meanY[s]) * step;
+                cxx[s] += w * dx * (x - meanX[s]);
+                cxy[s] += w * dx * (y - meanY[s]);
+                n[s] = total;
+            }
+        }
+        partial[worker].resize(count);
+        for (size_t s = 0; s < count; ++s) {
+            Moments& moments = partial[worker][s];
+            moments.n = n[s];
+            moments.meanX = meanX[s];
+            moments.meanY = meanY[s];
+            moments.cxx = cxx[s];
+            moments.cxy = cxy[s];
+        }
+    });
+
+    for (const std::vector<Moments>& block : partial) {
+        for (size_t s = 0; s < count; ++s) {
+            series[s].moments.merge(block[s]);
+        }
+    }
+}
+
+// Function to fold changed and new periods into the fits in O(1) per period
+void RegressionEngine::update(const WeatherRollup& rollup, int64_t fromPeriod) {
+    if (empty()) {
+        return;
+    }
+    if (rollup.firstPeriod(level) != firstPeriod) {
+        std::vector<size_t> columns;
+        for (const Series& entry : series) {
+            columns.push_back(entry.column);
+        }
+        build(rollup, columns, level, workers);
+        return;
+    }
+
+    size_t periods = rollup.bucketCount(level);
+    size_t from = fromPeriod <= firstPeriod ? 0 : std::min(static_cast<size_t>(fromPeriod - firstPeriod), periods);
+    for (Series& entry : series) {
+        const WeatherRollup::Bucket* buckets = rollup.buckets(level, entry.column);
+        if (buckets == nullptr) {
+            continue;
+        }
+        entry.values.resize(periods, std::numeric_limits<double>::quiet_NaN());
+        for (size_t i = from; i < periods; ++i) {
+            double x = static_cast<double>(firstPeriod + static_cast<int64_t>(i));
+            double previous = entry.values[i];
+            double current = buckets[i].count > 0 ? buckets[i].mean() : std::numeric_limits<double>::quiet_NaN();
+            if (previous == current) {
+                continue; // Period untouched by the new rows
+            }
+            if (!std::isnan(previous)) {
+                entry.moments.remove(x, previous);
+            }
+            if (!std::isnan(current)) {
+                entry.moments.add(x, current);
+            }
+            entry.values[i] = current;
+        }
+    }
+}
+
+int RegressionEngine::seriesIndex(size_t column) const {
+    for (size_t s = 0; s < series.size(); ++s) {
+        if (series[s].column == column) {
+            return static_cast<int>(s);
+        }
+    }
+    return -1;
+}
+
+RegressionEngine::Fit RegressionEngine::fit(size_t column) const {
+    Fit result;
+    int index = seriesIndex(column);
+    if (index == -1) {
+        return result;
+    }
+    const Series& entry = series[static_cast<size_t>(index)];
+    result.points = static_cast<size_t>(entry.moments.n);
+    result.valid = entry.moments.fit(result.slope, result.intercept);
+    for (size_t i = entry.values.size(); i > 0; --i) {
+        if (!std::isnan(entry.values[i - 1])) {
+            result.lastPeriod = firstPeriod + static_cast<int64_t>(i - 1);
+            break;
+        }
+    }
+    return result;
+}
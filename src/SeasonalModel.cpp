@@ -0,0 +1,249 @@
+#include "SeasonalModel.h"
+#include <algorithm>
+#include <cmath>
+#include "Parallel.h"
+#include "ReduceKernels.h"
+
+namespace {
+    const double TWO_PI = 6.28318530717958647692;
+    const double SECONDS_PER_YEAR = 365.2425 * 86400.0; // Mean Gregorian year
+    const int64_t SECONDS_PER_DAY = 86400;
+    const int64_t SECONDS_PER_HOUR = 3600;
+
+    // Rows packed per block before the dot kernels run over it
+    const size_t BLOCK_ROWS = 256;
+
+    /**
+     * @brief Position of t within a cycle of `length` seconds, in [0, 1)
+     */
+    double cyclePhase(double t, double length)
+    {
+        double phase = std::fmod(t, length) / length;
+        return phase < 0.0 ? phase + 1.0 : phase;
+    }
+
+    /**
+     * @brief Write cos(k * angle), sin(k * angle) for k = 1..harmonics, using the angle-addition recurrence
+     */
+    void writeHarmonics(double angle, int harmonics, double* out)
+    {
+        double c1 = std::cos(angle);
+        double s1 = std::sin(angle);
+        double c = c1;
+        double s = s1;
+        for (int k = 0; k < harmonics; ++k) {
+            out[2 * k] = c;
+            out[2 * k + 1] = s;
+            double next = c * c1 - s * s1;
+            s = s * c1 + c * s1;
+            c = next;
+        }
+    }
+
+    /**
+     * @brief X^T X, X^T y and y^T y of one worker's rows
+     */
+    struct NormalEquations {
+        std::vector<double> xtx; // Row-major, upper triangle filled
+        std::vector<double> xty;
+        double yty = 0.0;
+        double sumY = 0.0;
+        size_t count = 0;
+    };
+
+    /**
+     * @brief Solve a * x = b for a symmetric positive definite n x n matrix; b is overwritten with x
+     */
+    bool choleskySolve(std::vector<double> a, std::vector<double>& b, size_t n)
+    {
+        // a = L L^T, with L stored in the lower triangle
+        for (size_t j = 0; j < n; ++j) {
+            double diagonal = a[j * n + j];
+            for (size_t k = 0; k < j; ++k) {
+                diagonal -= a[j * n + k] * a[j * n + k];
+            }
+            if (diagonal <= 0.0) {
+                return false;
+            }
+            a[j * n + j] = std::sqrt(diagonal);
+            for (size_t i = j + 1; i < n; ++i) {
+                double value = a[i * n + j];
+                for (size_t k = 0; k < j; ++k) {
+                    value -= a[i * n + k] * a[j * n + k];
+                }
+                a[i * n + j] = value / a[j * n + j];
+            }
+        }
+        // L z = b, then L^T x = z
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = 0; k < i; ++k) {
+                b[i] -= a[i * n + k] * b[k];
+            }
+            b[i] /= a[i * n + i];
+        }
+        for (size_t i = n; i > 0; --i) {
+            size_t row = i - 1;
+            for (size_t k = row + 1; k < n; ++k) {
+                b[row] -= a[k * n + row] * b[k];
+            }
+            b[row] /= a[row * n + row];
+        }
+        return true;
+    }
+}
+
+SeasonalModel::SeasonalModel(int annualHarmonics, int diurnalHarmonics)
+    : annual(std::max(annualHarmonics, 0)),
+      diurnal(std::max(diurnalHarmonics, 0)),
+      origin(0),
+      pointCount(0),
+      rootMeanSquare(0.0),
+      determination(0.0) {}
+
+void SeasonalModel::features(int64_t epochSeconds, double* out) const {
+    out[0] = 1.0;
+    out[1] = static_cast<double>(epochSeconds - origin) / SECONDS_PER_YEAR;
+    double t = static_cast<double>(epochSeconds);
+    writeHarmonics(TWO_PI * cyclePhase(t, SECONDS_PER_YEAR), annual, out + 2);
+    writeHarmonics(TWO_PI * cyclePhase(t, static_cast<double>(SECONDS_PER_DAY)), diurnal, out + 2 + 2 * annual);
+}
+
+// Function to accumulate the normal equations over every reading and solve them
+bool SeasonalModel::fit(const int64_t* timestamps, const double* values, size_t rows, unsigned workers) {
+    coefficients.clear();
+    pointCount = 0;
+    size_t p = featureCount();
+    if (rows == 0) {
+        return false;
+    }
+    origin = timestamps[0] / 2 + timestamps[rows - 1] / 2;
+
+    std::vector<std::pair<size_t, size_t>> ranges = Parallel::splitRange(rows, Parallel::workerCount(workers));
+    std::vector<NormalEquations> partial(ranges.size());
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        NormalEquations& sums = partial[worker];
+        sums.xtx.assign(p * p, 0.0);
+        sums.xty.assign(p, 0.0);
+
+        // Feature-major block: block[f * BLOCK_ROWS + r] is feature f of packed row r
+        std::vector<double> block(p * BLOCK_ROWS);
+        std::vector<double> targets(BLOCK_ROWS);
+        std::vector<double> row(p);
+        size_t filled = 0;
+        auto flush = [&]() {
+            for (size_t i = 0; i < p; ++i) {
+                const double* fi = block.data() + i * BLOCK_ROWS;
+                for (size_t j = i; j < p; ++j) {
+                    sums.xtx[i * p + j] += ReduceKernels::dot(fi, block.data() + j * BLOCK_ROWS, filled);
+                }
+                sums.xty[i] += ReduceKernels::dot(fi, targets.data(), filled);
+            }
+            sums.yty += ReduceKernels::dot(targets.data(), targets.data(), filled);
+            filled = 0;
+        };
+
+        for (size_t r = ranges[worker].first; r < ranges[worker].second; ++r) {
+            double value = values[r];
+            if (std::isnan(value)) {
+                continue;
+            }
+            features(timestamps[r], row.data());
+            for (size_t f = 0; f < p; ++f) {
+                block[f * BLOCK_ROWS + filled] = row[f];
+            }
+            targets[filled] = value;
+            sums.sumY += value;
+            ++sums.count;
+            if (++filled == BLOCK_ROWS) {
+                flush();
+            }
+        }
+        if (filled > 0) {
+            flush();
+        }
+    });
+
+    NormalEquations total;
+    total.xtx.assign(p * p, 0.0);
+    total.xty.assign(p, 0.0);
+    for (const NormalEquations& sums : partial) {
+        for (size_t i = 0; i < p * p; ++i) {
+            total.xtx[i] += sums.xtx[i];
+        }
+        for (size_t i = 0; i < p; ++i) {
+            total.xty[i] += sums.xty[i];
+        }
+        total.yty += sums.yty;
+        total.sumY += sums.sumY;
+        total.count += sums.count;
+    }
+    if (total.count <= p) {
+        return false;
+    }
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            total.xtx[i * p + j] = total.xtx[j * p + i];
+        }
+    }
+
+    std::vector<double> solution = total.xty;
+    if (!choleskySolve(total.xtx, solution, p)) {
+        return false;
+    }
+    coefficients = solution;
+    pointCount = total.count;
+
+    // Residual sum of squares from the accumulated sums: y'y - 2 b'X'y + b'X'X b
+    double fitted = 0.0;
+    double explained = 0.0;
+    for (size_t i = 0; i < p; ++i) {
+        fitted += coefficients[i] * total.xty[i];
+        for (size_t j = 0; j < p; ++j) {
+            explained += coefficients[i] * total.xtx[i * p + j] * coefficients[j];
+        }
+    }
+    double residual = std::max(total.yty - 2.0 * fitted + explained, 0.0);
+    double n = static_cast<double>(total.count);
+    double variance = total.yty - total.sumY * total.sumY / n;
+    rootMeanSquare = std::sqrt(residual / n);
+    determination = variance > 0.0 ? 1.0 - residual / variance : 0.0;
+    return true;
+}
+
+double SeasonalModel::predict(int64_t epochSeconds) const {
+    if (!fitted()) {
+        return 0.0;
+    }
+    std::vector<double> row(featureCount());
+    features(epochSeconds, row.data());
+    double value = 0.0;
+    for (size_t i = 0; i < row.size(); ++i) {
+        value += coefficients[i] * row[i];
+    }
+    return value;
+}
+
+double SeasonalModel::periodMean(WeatherRollup::Granularity granularity, int64_t period) const {
+    int64_t start = WeatherRollup::periodStart(granularity, period);
+    int64_t end = WeatherRollup::periodStart(granularity, period + 1);
+    double sum = 0.0;
+    size_t count = 0;
+    for (int64_t t = start; t < end; t += SECONDS_PER_HOUR) {
+        sum += predict(t);
+        ++count;
+    }
+    return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+
+double SeasonalModel::trendPerYear() const {
+    return fitted() ? coefficients[1] : 0.0;
+}
+
+double SeasonalModel::annualAmplitude() const {
+    return (fitted() && annual > 0) ? std::hypot(coefficients[2], coefficients[3]) : 0.0;
+}
+
+double SeasonalModel::diurnalAmplitude() const {
+    size_t first = static_cast<size_t>(2 + 2 * annual);
+    return (fitted() && diurnal > 0) ? std::hypot(coefficients[first], coefficients[first + 1]) : 0.0;
+}
@@ -0,0 +1,124 @@
+#include "SeriesCache.h"
+#include <functional>
+#include <limits>
+
+const int64_t SeriesCache::FULL_RANGE_FROM = std::numeric_limits<int64_t>::min();
+const int64_t SeriesCache::FULL_RANGE_TO = std::numeric_limits<int64_t>::max();
+
+namespace {
+    /**
+     * @brief Mix one more hash into a running seed (boost::hash_combine)
+     */
+    void combineHash(size_t& seed, size_t value)
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+}
+
+SeriesCache::Key::Key(const std::string& country_, const std::string& metric_, WeatherRollup::Granularity granularity_,
+                      const std::string& aggregate_, int64_t from_, int64_t to_)
+    : country(country_), metric(metric_), granularity(granularity_), from(from_), to(to_), aggregate(aggregate_) {}
+
+bool SeriesCache::Key::operator==(const Key& other) const {
+    return granularity == other.granularity && from == other.from && to == other.to &&
+           country == other.country && metric == other.metric && aggregate == other.aggregate;
+}
+
+size_t SeriesCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = std::hash<std::string>()(key.country);
+    combineHash(seed, std::hash<std::string>()(key.metric));
+    combineHash(seed, static_cast<size_t>(key.granularity));
+    combineHash(seed, std::hash<int64_t>()(key.from));
+    combineHash(seed, std::hash<int64_t>()(key.to));
+    combineHash(seed, std::hash<std::string>()(key.aggregate));
+    return seed;
+}
+
+SeriesCache::SeriesCache(size_t capacityBytes_)
+    : capacityBytes(capacityBytes_), usedBytes(0), hitCount(0), missCount(0), evictionCount(0) {}
+
+std::shared_ptr<const SeriesCache::Series> SeriesCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = lookup.find(key);
+    if (it == lookup.end()) {
+        ++missCount;
+        return nullptr;
+    }
+    ++hitCount;
+    recency.splice(recency.begin(), recency, it->second);
+    return it->second->series;
+}
+
+// Function to insert a series and evict least recently used entries over budget
+std::shared_ptr<const SeriesCache::Series> SeriesCache::store(const Key& key, Series series) {
+    size_t bytes = entryBytes(key, series);
+    std::shared_ptr<const Series> shared = std::make_shared<const Series>(std::move(series));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        usedBytes -= it->second->bytes;
+        recency.erase(it->second);
+        lookup.erase(it);
+    }
+    if (bytes > capacityBytes) {
+        return shared; // Would evict everything else and still not fit
+    }
+
+    recency.push_front({ key, shared, bytes });
+    lookup.emplace(key, recency.begin());
+    usedBytes += bytes;
+    evictToCapacity();
+    return shared;
+}
+
+void SeriesCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lookup.clear();
+    recency.clear();
+    usedBytes = 0;
+}
+
+size_t SeriesCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return usedBytes;
+}
+
+size_t SeriesCache::entries() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lookup.size();
+}
+
+uint64_t SeriesCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+uint64_t SeriesCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
+
+uint64_t SeriesCache::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return evictionCount;
+}
+
+size_t SeriesCache::entryBytes(const Key& key, const Series& series) {
+    // Entry, list node and hash node overhead, the key strings and the series payload
+    size_t bytes = sizeof(Entry) + sizeof(Series) + sizeof(Key) + 4 * sizeof(void*);
+    bytes += key.country.capacity() + key.metric.capacity() + key.aggregate.capacity();
+    bytes += series.candles.capacity() * sizeof(Candlestick);
+    bytes += series.points.capacity() * sizeof(std::pair<int, double>);
+    return bytes;
+}
+
+void SeriesCache::evictToCapacity() {
+    while (usedBytes > capacityBytes && !recency.empty()) {
+        const Entry& coldest = recency.back();
+        usedBytes -= coldest.bytes;
+        lookup.erase(coldest.key);
+        recency.pop_back();
+        ++evictionCount;
+    }
+}
@@ -0,0 +1,171 @@
+#include "TDigest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    const double PI = 3.14159265358979323846;
+
+    /**
+     * @brief k1 scale function: a centroid may span at most one unit of k
+     */
+    double scaleK(double q, double compression)
+    {
+        return compression / (2.0 * PI) * std::asin(2.0 * std::min(1.0, std::max(0.0, q)) - 1.0);
+    }
+}
+
+TDigest::TDigest(double compression_)
+    : compression(compression_),
+      totalWeight(0.0),
+      minValue(std::numeric_limits<double>::quiet_NaN()),
+      maxValue(std::numeric_limits<double>::quiet_NaN()) {}
+
+void TDigest::add(double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    if (empty()) {
+        minValue = value;
+        maxValue = value;
+    } else {
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    buffer.push_back(value);
+    // Buffer a few multiples of the centroid budget so each sort is amortised
+    if (buffer.size() >= static_cast<size_t>(compression) * 5) {
+        flush();
+    }
+}
+
+void TDigest::add(const double* values, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        add(values[i]);
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.empty()) {
+        return;
+    }
+    if (empty()) {
+        minValue = other.minValue;
+        maxValue = other.maxValue;
+    } else {
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+    // The other side's centroids re-enter the merge pass with their weights
+    std::vector<Centroid> incoming = other.centroids;
+    for (double value : other.buffer) {
+        incoming.push_back({ value, 1.0 });
+    }
+    compress(incoming);
+}
+
+void TDigest::flush() {
+    if (!buffer.empty()) {
+        std::vector<Centroid> incoming;
+        compress(incoming);
+    }
+}
+
+// Function to fold the buffer and extra centroids into a fresh centroid list
+void TDigest::compress(std::vector<Centroid>& incoming) {
+    for (double value : buffer) {
+        incoming.push_back({ value, 1.0 });
+    }
+    buffer.clear();
+    incoming.insert(incoming.end(), centroids.begin(), centroids.end());
+    if (incoming.empty()) {
+        return;
+    }
+
+    std::sort(incoming.begin(), incoming.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    double total = 0.0;
+    for (const Centroid& centroid : incoming) {
+        total += centroid.weight;
+    }
+    totalWeight = total;
+
+    // Within the centroid budget nothing needs clustering, which keeps small inputs exact
+    if (incoming.size() <= static_cast<size_t>(compression)) {
+        centroids.swap(incoming);
+        return;
+    }
+
+    // Greedy pass: extend the current centroid while it spans at most one unit of k
+    centroids.clear();
+    double weightBefore = 0.0;
+    Centroid current = incoming[0];
+    for (size_t i = 1; i < incoming.size(); ++i) {
+        const Centroid& next = incoming[i];
+        double kLeft = scaleK(weightBefore / total, compression);
+        double kRight = scaleK((weightBefore + current.weight + next.weight) / total, compression);
+        if (kRight - kLeft <= 1.0) {
+            double weight = current.weight + next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / weight;
+            current.weight = weight;
+        } else {
+            centroids.push_back(current);
+            weightBefore += current.weight;
+            current = next;
+        }
+    }
+    centroids.push_back(current);
+}
+
+size_t TDigest::centroidCount() const {
+    TDigest copy(*this);
+    copy.flush();
+    return copy.centroids.size();
+}
+
+// Function to estimate a quantile by interpolating between centroid centres
+double TDigest::quantile(double q) const {
+    if (empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (!buffer.empty()) {
+        TDigest copy(*this);
+        copy.flush();
+        return copy.quantile(q);
+    }
+
+    q = std::min(1.0, std::max(0.0, q));
+    if (centroids.size() == 1) {
+        return centroids[0].weight == 1.0 ? centroids[0].mean : minValue + q * (maxValue - minValue);
+    }
+
+    // Each centroid's mass is centred at (weight before) + weight / 2
+    double target = q * totalWeight;
+    const Centroid& first = centroids.front();
+    if (target < first.weight / 2.0) {
+        if (first.weight == 1.0) {
+            return minValue;
+        }
+        return minValue + (first.mean - minValue) * target / (first.weight / 2.0);
+    }
+    const Centroid& last = centroids.back();
+    if (target > totalWeight - last.weight / 2.0) {
+        if (last.weight == 1.0) {
+            return maxValue;
+        }
+        double fromEnd = totalWeight - target;
+        return maxValue - (maxValue - last.mean) * fromEnd / (last.weight / 2.0);
+    }
+
+    double weightBefore = 0.0;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+        double centre = weightBefore + centroids[i].weight / 2.0;
+        double nextCentre = weightBefore + centroids[i].weight + centroids[i + 1].weight / 2.0;
+        if (target <= nextCentre) {
+            double t = (target - centre) / (nextCentre - centre);
+            return centroids[i].mean + t * (centroids[i + 1].mean - centroids[i].mean);
+        }
+        weightBefore += centroids[i].weight;
+    }
+    return last.mean;
+}
@@ -0,0 +1,141 @@
+#include "TextFrame.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+    // Worst case per cell: a color escape plus a four-byte character
+    const size_t BYTES_PER_CELL = 9;
+
+    /**
+     * @brief SGR escape selecting a foreground color (Default resets all attributes)
+     */
+    const char* escapeFor(TextFrame::Color color)
+    {
+        switch (color) {
+            case TextFrame::Color::Red:
+                return "\033[31m";
+            case TextFrame::Color::Green:
+                return "\033[32m";
+            case TextFrame::Color::Blue:
+                return "\033[34m";
+            default:
+                return "\033[0m";
+        }
+    }
+
+    /**
+     * @brief Byte length of the UTF-8 character starting with `lead` (1 for stray bytes)
+     */
+    size_t utf8Length(unsigned char lead)
+    {
+        if (lead >= 0xF0) return 4;
+        if (lead >= 0xE0) return 3;
+        if (lead >= 0xC0) return 2;
+        return 1;
+    }
+}
+
+TextFrame::TextFrame(size_t width, size_t height)
+    : columns(width), rows(height), cells(width * height, Cell{{' ', 0, 0, 0}, 1, Color::Default}) {
+    output.reserve(rows * (columns * BYTES_PER_CELL + 1));
+}
+
+void TextFrame::put(size_t row, size_t column, const char* glyph, Color color) {
+    if (row >= rows || column >= columns) {
+        return;
+    }
+    Cell& cell = cells[row * columns + column];
+    size_t size = utf8Length(static_cast<unsigned char>(glyph[0]));
+    size_t copied = 0;
+    while (copied < size && glyph[copied] != '\0') {
+        cell.bytes[copied] = glyph[copied];
+        ++copied;
+    }
+    cell.size = static_cast<unsigned char>(copied > 0 ? copied : 1);
+    if (copied == 0) {
+        cell.bytes[0] = ' ';
+    }
+    cell.color = color;
+}
+
+size_t TextFrame::text(size_t row, size_t column, const std::string& value, Color color) {
+    size_t i = 0;
+    while (i < value.size()) {
+        put(row, column, value.c_str() + i, color);
+        i += utf8Length(static_cast<unsigned char>(value[i]));
+        ++column;
+    }
+    return column;
+}
+
+// Function to compose the frame into the output buffer
+const std::string& TextFrame::render(bool color) {
+    output.clear();
+    for (size_t row = 0; row < rows; ++row) {
+        const Cell* line = cells.data() + row * columns;
+        size_t end = columns;
+        while (end > 0 && line[end - 1].size == 1 && line[end - 1].bytes[0] == ' ') {
+            --end;
+        }
+
+        Color current = Color::Default;
+        for (size_t column = 0; column < end; ++column) {
+            const Cell& cell = line[column];
+            bool blank = (cell.size == 1 && cell.bytes[0] == ' ');
+            if (color && !blank && cell.color != current) {
+                output += escapeFor(cell.color);
+                current = cell.color;
+            }
+            output.append(cell.bytes, cell.size);
+        }
+        // Every line ends uncolored, so piped or paged output stays intact line by line
+        if (current != Color::Default) {
+            output += escapeFor(Color::Default);
+        }
+        output += '\n';
+    }
+    return output;
+}
+
+void TextFrame::print() {
+    render(colorEnabled());
+    std::cout.flush();
+    const char* data = output.data();
+    size_t remaining = output.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(STDOUT_FILENO, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: Could not write chart: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+bool TextFrame::colorEnabled() {
+    return std::getenv("NO_COLOR") == nullptr && ::isatty(STDOUT_FILENO) == 1;
+}
+
+size_t TextFrame::terminalWidth(size_t fallback) {
+    struct winsize size;
+    if (::isatty(STDOUT_FILENO) == 1 && ::ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+    const char* columns = std::getenv("COLUMNS");
+    if (columns != nullptr) {
+        long value = std::strtol(columns, nullptr, 10);
+        if (value > 0) {
+            return static_cast<size_t>(value);
+        }
+    }
+    return fallback;
+}
@@ -0,0 +1,92 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <utility>
+#include "Parallel.h"
+
+ThreadPool::ThreadPool(unsigned workers)
+    : stopping(false) {
+    unsigned count = Parallel::workerCount(workers);
+    for (unsigned i = 0; i < count; ++i) {
+        threads.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+ThreadPool::Batch::~Batch() {
+    if (pool != nullptr) {
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->batchDone.wait(lock, [this] { return pending == 0; });
+    }
+}
+
+void ThreadPool::submit(Batch& batch, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.pool = this;
+        ++batch.pending;
+        tasks.push_back(Task{std::move(task), &batch});
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::runTask(Task task, std::unique_lock<std::mutex>& lock) {
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+        task.run();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+    if (error && !task.batch->error) {
+        task.batch->error = error;
+    }
+    if (--task.batch->pending == 0) {
+        batchDone.notify_all();
+    }
+}
+
+void ThreadPool::wait(Batch& batch) {
+    std::unique_lock<std::mutex> lock(mutex);
+    // Help with this batch's queued tasks only, so a cheap batch is never stuck behind
+    // another caller's expensive ones; then wait for its tasks still running on the workers
+    while (batch.pending > 0) {
+        auto own = std::find_if(tasks.begin(), tasks.end(), [&batch](const Task& task) { return task.batch == &batch; });
+        if (own == tasks.end()) {
+            break;
+        }
+        Task task = std::move(*own);
+        tasks.erase(own);
+        runTask(std::move(task), lock);
+    }
+    batchDone.wait(lock, [&batch] { return batch.pending == 0; });
+    if (batch.error) {
+        std::exception_ptr error = std::move(batch.error);
+        batch.error = nullptr;
+        lock.unlock();
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (stopping && tasks.empty()) {
+            return;
+        }
+        Task task = std::move(tasks.front());
+        tasks.pop_front();
+        runTask(std::move(task), lock);
+    }
+}
@@ -0,0 +1,159 @@
+#include "TimeUtils.h"
+
+namespace {
+    const int64_t SECONDS_PER_DAY = 86400;
+
+    /**
+     * @brief Read a fixed number of decimal digits starting at pos
+     */
+    bool readDigits(std::string_view text, size_t pos, size_t count, int& value)
+    {
+        if (pos + count > text.size()) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = pos; i < pos + count; ++i) {
+            char c = text[i];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        return true;
+    }
+
+    /**
+     * @brief Floor division for negative day counts
+     */
+    int64_t floorDiv(int64_t a, int64_t b)
+    {
+        int64_t q = a / b;
+        if ((a % b != 0) && ((a < 0) != (b < 0))) {
+            --q;
+        }
+        return q;
+    }
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+int64_t TimeUtils::daysFromCivil(int year, int month, int day) {
+    int64_t y = static_cast<int64_t>(year) - (month <= 2 ? 1 : 0);
+    int64_t era = floorDiv(y, 400);
+    int64_t yoe = y - era * 400;                                       // [0, 399]
+    int64_t mp = (month + 9) % 12;                                     // March = 0
+    int64_t doy = (153 * mp + 2) / 5 + day - 1;                        // [0, 365]
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;               // [0, 146096]
+    return era * 146097 + doe - 719468;
+}
+
+void TimeUtils::civilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    int64_t era = floorDiv(days, 146097);
+    int64_t doe = days - era * 146097;                                 // [0, 146096]
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);             // [0, 365]
+    int64_t mp = (5 * doy + 2) / 153;                                  // [0, 11]
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// Function to parse an ISO-8601 UTC timestamp
+bool TimeUtils::parseTimestamp(std::string_view text, int64_t& epochSeconds) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (!readDigits(text, 0, 4, year) || text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+        !readDigits(text, 5, 2, month) || !readDigits(text, 8, 2, day)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    // Optional time part: "THH:MM:SS" or " HH:MM:SS"
+    if (text.size() >= 19 && (text[10] == 'T' || text[10] == ' ')) {
+        if (!readDigits(text, 11, 2, hour) || text[13] != ':' ||
+            !readDigits(text, 14, 2, minute) || text[16] != ':' ||
+            !readDigits(text, 17, 2, second)) {
+            return false;
+        }
+    }
+    epochSeconds = toEpoch(year, month, day, hour, minute, second);
+    return true;
+}
+
+// Function to parse a date or date-time typed by the user, rejecting anything loose
+bool TimeUtils::parseDateTime(std::string_view text, int64_t& epochSeconds) {
+    if (text.size() != 10 && text.size() != 19) {
+        return false;
+    }
+    if (text.size() == 19 && text[10] != 'T' && text[10] != ' ') {
+        return false;
+    }
+    int64_t parsed = 0;
+    if (!parseTimestamp(text, parsed)) {
+        return false;
+    }
+    // parseTimestamp lets a day overflow into the next month; the round trip catches it
+    int year = 0, month = 0, day = 0;
+    int givenYear = 0, givenMonth = 0, givenDay = 0;
+    readDigits(text, 0, 4, givenYear);
+    readDigits(text, 5, 2, givenMonth);
+    readDigits(text, 8, 2, givenDay);
+    toCivil(parsed, year, month, day);
+    if (year != givenYear || month != givenMonth || day != givenDay) {
+        return false;
+    }
+    if (text.size() == 19) {
+        int hour = 0, minute = 0, second = 0;
+        readDigits(text, 11, 2, hour);
+        readDigits(text, 14, 2, minute);
+        readDigits(text, 17, 2, second);
+        if (hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+    }
+    epochSeconds = parsed;
+    return true;
+}
+
+int64_t TimeUtils::toEpoch(int year, int month, int day, int hour, int minute, int second) {
+    return daysFromCivil(year, month, day) * SECONDS_PER_DAY + hour * 3600 + minute * 60 + second;
+}
+
+void TimeUtils::toCivil(int64_t epochSeconds, int& year, int& month, int& day) {
+    civilFromDays(floorDiv(epochSeconds, SECONDS_PER_DAY), year, month, day);
+}
+
+// Function to format an epoch timestamp as ISO-8601 UTC
+void TimeUtils::formatTimestamp(int64_t epochSeconds, char* out) {
+    int64_t days = floorDiv(epochSeconds, SECONDS_PER_DAY);
+    int64_t seconds = epochSeconds - days * SECONDS_PER_DAY;
+    int year = 0, month = 0, day = 0;
+    civilFromDays(days, year, month, day);
+    auto two = [](char* at, int value) {
+        at[0] = static_cast<char>('0' + value / 10);
+        at[1] = static_cast<char>('0' + value % 10);
+    };
+    two(out, year / 100 % 100);
+    two(out + 2, year % 100);
+    out[4] = '-';
+    two(out + 5, month);
+    out[7] = '-';
+    two(out + 8, day);
+    out[10] = 'T';
+    two(out + 11, static_cast<int>(seconds / 3600));
+    out[13] = ':';
+    two(out + 14, static_cast<int>(seconds / 60 % 60));
+    out[16] = ':';
+    two(out + 17, static_cast<int>(seconds % 60));
+    out[19] = 'Z';
+}
+
+int TimeUtils::yearOf(int64_t epochSeconds) {
+    int year = 0, month = 0, day = 0;
+    toCivil(epochSeconds, year, month, day);
+    return year;
+}
+
+int64_t TimeUtils::dayNumber(int64_t epochSeconds) {
+    return floorDiv(epochSeconds, SECONDS_PER_DAY);
+}
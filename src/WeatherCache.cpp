@@ -0,0 +1,285 @@
+#include "WeatherCache.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include <sys/stat.h>
+
+namespace {
+    const char CACHE_MAGIC[8] = { 'W', 'X', 'C', 'A', 'C', 'H', 'E', '1' };
+    const uint32_t CACHE_VERSION = 3;
+    const uint64_t CACHE_ALIGNMENT = 64;
+
+    /**
+     * @brief Fixed-size file header
+     */
+    struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t columnCount;
+        uint64_t rowCount;
+        uint64_t namesOffset;
+        uint64_t statsOffset;      // Per column: missing and invalid cell counts
+        uint64_t skippedRows;
+        uint64_t timestampsOffset;
+        uint64_t columnsOffset;
+        uint64_t columnStride;     // Bytes from one column array to the next
+        uint64_t sourceSize;       // CSV bytes the cache holds: complete lines only
+    };
+
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+    }
+
+    /**
+     * @brief Pad the stream with zero bytes up to the given offset
+     */
+    void padTo(std::ofstream& out, uint64_t& position, uint64_t offset)
+    {
+        static const char zeros[CACHE_ALIGNMENT] = {};
+        while (position < offset) {
+            uint64_t n = std::min<uint64_t>(offset - position, CACHE_ALIGNMENT);
+            out.write(zeros, static_cast<std::streamsize>(n));
+            position += n;
+        }
+    }
+
+    /**
+     * @brief Whether bytes starting at begin end at or before limit, without overflowing
+     */
+    bool sectionFits(uint64_t begin, uint64_t bytes, uint64_t limit)
+    {
+        return begin <= limit && bytes <= limit - begin;
+    }
+
+    /**
+     * @brief Whether every section lies inside the file, in the order write() lays them out
+     */
+    bool sectionsFit(const CacheHeader& header, uint64_t fileSize)
+    {
+        if (header.rowCount == 0 || header.rowCount > fileSize / sizeof(double)) {
+            return false;
+        }
+        if (header.timestampsOffset % CACHE_ALIGNMENT != 0 || header.columnsOffset % CACHE_ALIGNMENT != 0 ||
+            header.columnStride % CACHE_ALIGNMENT != 0) {
+            return false;
+        }
+        uint64_t arrayBytes = header.rowCount * sizeof(double);
+        uint64_t statsBytes = static_cast<uint64_t>(header.columnCount) * 2 * sizeof(uint64_t);
+        if (header.namesOffset < sizeof(CacheHeader) ||
+            !sectionFits(header.namesOffset, 0, header.statsOffset) ||
+            !sectionFits(header.statsOffset, statsBytes, header.timestampsOffset) ||
+            !sectionFits(header.timestampsOffset, arrayBytes, header.columnsOffset) ||
+            !sectionFits(header.columnsOffset, 0, fileSize)) {
+            return false;
+        }
+        if (header.columnCount == 0) {
+            return true;
+        }
+        // Columns are a stride apart; the last one is not padded
+        if (header.columnStride < arrayBytes || !sectionFits(header.columnsOffset, arrayBytes, fileSize)) {
+            return false;
+        }
+        uint64_t spare = fileSize - header.columnsOffset - arrayBytes;
+        return header.columnCount - 1 <= spare / header.columnStride;
+    }
+
+    bool statFile(const std::string& filename, struct stat& st)
+    {
+        return ::stat(filename.c_str(), &st) == 0;
+    }
+}
+
+std::string WeatherCache::cachePathFor(const std::string& csvFilename) {
+    return csvFilename + ".cache";
+}
+
+// Function to check that a cache was built from the current CSV file
+bool WeatherCache::isFresh(const std::string& cacheFilename, const std::string& csvFilename) {
+    struct stat cacheStat;
+    struct stat csvStat;
+    if (!statFile(cacheFilename, cacheStat) || !statFile(csvFilename, csvStat)) {
+        return false;
+    }
+    if (cacheStat.st_mtime < csvStat.st_mtime) {
+        return false; // CSV modified after the cache was written
+    }
+
+    // Same-second appends are caught by the recorded source size
+    CacheHeader header;
+    std::ifstream in(cacheFilename, std::ios::binary);
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    uint64_t csvSize = static_cast<uint64_t>(csvStat.st_size);
+    if (header.sourceSize == csvSize) {
+        return true;
+    }
+    if (header.sourceSize > csvSize) {
+        return false;
+    }
+    // Anything past the cached bytes must be a line still being written, i.e. hold no newline
+    std::ifstream csv(csvFilename, std::ios::binary);
+    std::string tail(csvSize - header.sourceSize, '\0');
+    if (!csv.seekg(static_cast<std::streamoff>(header.sourceSize)) ||
+        !csv.read(&tail[0], static_cast<std::streamsize>(tail.size()))) {
+        return false;
+    }
+    return tail.find('\n') == std::string::npos;
+}
+
+// Function to serialise a table to the binary cache format
+bool WeatherCache::write(const WeatherTable& table, const std::string& cacheFilename, const std::string& csvFilename) {
+    struct stat csvStat;
+    if (table.empty() || !statFile(csvFilename, csvStat)) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.columnCount = static_cast<uint32_t>(table.columnCount());
+    header.rowCount = table.rowCount();
+    header.sourceSize = table.consumedBytes();
+    header.skippedRows = table.skippedRowCount();
+
+    // Lay out the sections
+    uint64_t namesBytes = 0;
+    for (size_t c = 0; c < table.columnCount(); ++c) {
+        namesBytes += sizeof(uint32_t) + table.columnName(c).size();
+    }
+    header.namesOffset = alignUp(sizeof(CacheHeader));
+    header.statsOffset = alignUp(header.namesOffset + namesBytes);
+    header.timestampsOffset = alignUp(header.statsOffset + header.columnCount * 2 * sizeof(uint64_t));
+    header.columnsOffset = alignUp(header.timestampsOffset + header.rowCount * sizeof(int64_t));
+    header.columnStride = alignUp(header.rowCount * sizeof(double));
+
+    std::string tempFilename = cacheFilename + ".tmp";
+    std::ofstream out(tempFilename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Warning: Cannot write cache file " << tempFilename << std::endl;
+        return false;
+    }
+
+    uint64_t position = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    position += sizeof(header);
+
+    padTo(out, position, header.namesOffset);
+    for (size_t c = 0; c < table.columnCount(); ++c) {
+        const std::string& name = table.columnName(c);
+        uint32_t length = static_cast<uint32_t>(name.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        position += sizeof(length) + name.size();
+    }
+
+    padTo(out, position, header.statsOffset);
+    for (size_t c = 0; c < table.columnCount(); ++c) {
+        uint64_t counts[2] = { table.columnStats(c).missing, table.columnStats(c).invalid };
+        out.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+        position += sizeof(counts);
+    }
+
+    padTo(out, position, header.timestampsOffset);
+    out.write(reinterpret_cast<const char*>(table.timestamps()),
+              static_cast<std::streamsize>(header.rowCount * sizeof(int64_t)));
+    position += header.rowCount * sizeof(int64_t);
+
+    for (size_t c = 0; c < table.columnCount(); ++c) {
+        padTo(out, position, header.columnsOffset + c * header.columnStride);
+        out.write(reinterpret_cast<const char*>(table.column(c)),
+                  static_cast<std::streamsize>(header.rowCount * sizeof(double)));
+        position += header.rowCount * sizeof(double);
+    }
+
+    out.close();
+    if (!out || std::rename(tempFilename.c_str(), cacheFilename.c_str()) != 0) {
+        std::cerr << "Warning: Failed to write cache file " << cacheFilename << std::endl;
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Function to map a binary cache file into a table without copying the arrays
+bool WeatherCache::read(const std::string& cacheFilename, WeatherTable& table) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(cacheFilename) || file->size() < sizeof(CacheHeader)) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION) {
+        std::cerr << "Warning: " << cacheFilename << " is not a compatible cache file." << std::endl;
+        return false;
+    }
+    if (!sectionsFit(header, file->size())) {
+        std::cerr << "Warning: Cache file " << cacheFilename << " is truncated or corrupt." << std::endl;
+        return false;
+    }
+
+    table.clear();
+
+    // Column names
+    const char* cursor = file->data() + header.namesOffset;
+    const char* namesEnd = file->data() + header.statsOffset;
+    for (uint32_t c = 0; c < header.columnCount; ++c) {
+        uint32_t length = 0;
+        if (cursor + sizeof(length) > namesEnd) {
+            table.clear();
+            return false;
+        }
+        std::memcpy(&length, cursor, sizeof(length));
+        cursor += sizeof(length);
+        if (cursor + length > namesEnd) {
+            table.clear();
+            return false;
+        }
+        table.columnNames.emplace_back(cursor, length);
+        cursor += length;
+    }
+    table.tableSchema.build(table.columnNames);
+
+    // Error accounting
+    table.skippedRows = header.skippedRows;
+    table.sourceBytes = header.sourceSize;
+    table.stats.resize(header.columnCount);
+    for (uint32_t c = 0; c < header.columnCount; ++c) {
+        uint64_t counts[2];
+        std::memcpy(counts, file->data() + header.statsOffset + c * sizeof(counts), sizeof(counts));
+        table.stats[c].missing = counts[0];
+        table.stats[c].invalid = counts[1];
+    }
+
+    // Arrays are used in place
+    table.rows = header.rowCount;
+    table.timestampData = reinterpret_cast<const int64_t*>(file->data() + header.timestampsOffset);
+    table.checkTimestampOrder();
+    table.resetColumnViews(header.columnCount);
+    for (uint32_t c = 0; c < header.columnCount; ++c) {
+        table.columnData[c].store(reinterpret_cast<const double*>(file->data() + header.columnsOffset + c * header.columnStride));
+    }
+    table.mappedCache = std::move(file);
+    return true;
+}
+
+// Function to load through the binary cache, rebuilding it when it is stale
+bool WeatherCache::loadOrBuild(const std::string& csvFilename, WeatherTable& table, unsigned workers) {
+    std::string cacheFilename = cachePathFor(csvFilename);
+    if (isFresh(cacheFilename, csvFilename) && read(cacheFilename, table)) {
+        return true;
+    }
+
+    if (!table.load(csvFilename, workers)) {
+        return false;
+    }
+    write(table, cacheFilename, csvFilename); // A failed write only costs the next start-up
+    return true;
+}
@@ -0,0 +1,446 @@
+#include "WeatherRollup.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include "Parallel.h"
+#include "ReduceKernels.h"
+#include "TimeUtils.h"
+
+namespace {
+    const int64_t SECONDS_PER_DAY = 86400;
+
+    /**
+     * @brief Floor division for negative period keys
+     */
+    int64_t floorDiv(int64_t a, int64_t b)
+    {
+        int64_t q = a / b;
+        if ((a % b != 0) && ((a < 0) != (b < 0))) {
+            --q;
+        }
+        return q;
+    }
+}
+
+// ─────────────────────────────────────────────
+// Bucket
+// ─────────────────────────────────────────────
+WeatherRollup::Bucket::Bucket()
+    : sum(0.0),
+      min(std::numeric_limits<double>::max()),
+      max(std::numeric_limits<double>::lowest()),
+      first(std::numeric_limits<double>::quiet_NaN()),
+      last(std::numeric_limits<double>::quiet_NaN()),
+      count(0) {}
+
+void WeatherRollup::Bucket::add(double value) {
+    if (count == 0) {
+        first = value;
+    }
+    last = value;
+    sum += value;
+    ++count;
+    if (value < min) {
+        min = value;
+    }
+    if (value > max) {
+        max = value;
+    }
+}
+
+void WeatherRollup::Bucket::addRun(const double* values, size_t length) {
+    ReduceKernels::Summary summary;
+    ReduceKernels::reduce(values, length, summary);
+    if (summary.count == 0) {
+        return;
+    }
+    Bucket run;
+    run.sum = summary.sum;
+    run.count = summary.count;
+    run.min = summary.min;
+    run.max = summary.max;
+    run.first = values[ReduceKernels::firstPresent(values, length)];
+    run.last = values[ReduceKernels::lastPresent(values, length)];
+    merge(run);
+}
+
+void WeatherRollup::Bucket::merge(const Bucket& later) {
+    if (later.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = later;
+        return;
+    }
+    last = later.last;
+    sum += later.sum;
+    count += later.count;
+    min = std::min(min, later.min);
+    max = std::max(max, later.max);
+}
+
+// ─────────────────────────────────────────────
+// WeatherRollup
+// ─────────────────────────────────────────────
+WeatherRollup::WeatherRollup() {}
+
+void WeatherRollup::clear() {
+    for (Level& entry : levels) {
+        entry = Level();
+    }
+    columnSlots.clear();
+}
+
+bool WeatherRollup::hasColumn(size_t column) const {
+    return column < columnSlots.size() && columnSlots[column] != -1;
+}
+
+const WeatherRollup::Bucket* WeatherRollup::buckets(Granularity granularity, size_t column) const {
+    if (!hasColumn(column)) {
+        return nullptr;
+    }
+    return levels[level(granularity)].columns[columnSlots[column]].data();
+}
+
+// Function to build the day level from the rows and every coarser level from the one below
+bool WeatherRollup::build(const WeatherTable& table, const std::vector<size_t>& columnIndices, unsigned workers) {
+    clear();
+    if (table.empty()) {
+        std::cerr << "Error: CSV data is empty." << std::endl;
+        return false;
+    }
+
+    // Resolve the views first so lazily parsed columns are loaded before the workers start
+    std::vector<const double*> values;
+    columnSlots.assign(table.columnCount(), -1);
+    for (size_t index : columnIndices) {
+        if (index < table.columnCount() && columnSlots[index] == -1) {
+            columnSlots[index] = static_cast<int>(values.size());
+            values.push_back(table.column(index));
+        }
+    }
+
+    // Same-day runs of rows are found once, up front, and shared by every column
+    std::vector<Run> runs = periodRuns(table.timestamps(), 0, table.rowCount(), Granularity::Day,
+                                       table.timestampsAscending());
+    int64_t firstDay = std::numeric_limits<int64_t>::max();
+    int64_t lastDay = std::numeric_limits<int64_t>::min();
+    for (const Run& run : runs) {
+        firstDay = std::min(firstDay, run.period);
+        lastDay = std::max(lastDay, run.period);
+    }
+
+    // Dense period ranges of every level
+    for (size_t l = 0; l < LEVEL_COUNT; ++l) {
+        Granularity granularity = static_cast<Granularity>(l);
+        Level& target = levels[l];
+        target.firstPeriod = periodOf(granularity, firstDay * SECONDS_PER_DAY);
+        target.count = 0;
+        target.columns.resize(values.size());
+    }
+    extendLevels(lastDay);
+    Level& days = levels[level(Granularity::Day)];
+
+    // Parent bucket of each day and month, computed once for all columns
+    Parents parents = parentsFrom(0);
+
+    // Columns are independent: each worker builds the whole pyramid for its share
+    std::vector<std::pair<size_t, size_t>> ranges =
+        Parallel::splitRange(values.size(), Parallel::workerCount(workers));
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        for (size_t slot = ranges[worker].first; slot < ranges[worker].second; ++slot) {
+            const double* column = values[slot];
+            std::vector<Bucket>& dayBuckets = days.columns[slot];
+            dayBuckets.assign(days.count, Bucket());
+            for (const Run& run : runs) {
+                dayBuckets[static_cast<size_t>(run.period - days.firstPeriod)].addRun(column + run.begin, run.end - run.begin);
+            }
+            rollUp(slot, parents);
+        }
+    });
+    return true;
+}
+
+// Function to fold newly appended rows into the existing levels
+bool WeatherRollup::append(const WeatherTable& table, size_t firstRow, unsigned workers) {
+    if (empty() || firstRow == 0 || !table.timestampsAscending()) {
+        return build(table, builtColumns(), workers);
+    }
+    if (firstRow >= table.rowCount()) {
+        return true;
+    }
+
+    // Ascending order puts every new row on or after the last day already built
+    std::vector<Run> runs = periodRuns(table.timestamps(), firstRow, table.rowCount(), Granularity::Day, true);
+    extendLevels(runs.back().period);
+    Level& days = levels[level(Granularity::Day)];
+    Parents parents = parentsFrom(static_cast<size_t>(runs.front().period - days.firstPeriod));
+
+    std::vector<size_t> columns = builtColumns();
+    std::vector<const double*> values;
+    for (size_t index : columns) {
+        values.push_back(table.column(index));
+    }
+
+    std::vector<std::pair<size_t, size_t>> ranges =
+        Parallel::splitRange(values.size(), Parallel::workerCount(workers));
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        for (size_t slot = ranges[worker].first; slot < ranges[worker].second; ++slot) {
+            const double* column = values[slot];
+            std::vector<Bucket>& dayBuckets = days.columns[slot];
+            dayBuckets.resize(days.count);
+            for (const Run& run : runs) {
+                dayBuckets[static_cast<size_t>(run.period - days.firstPeriod)].addRun(column + run.begin, run.end - run.begin);
+            }
+            rollUp(slot, parents);
+        }
+    });
+    return true;
+}
+
+void WeatherRollup::extendLevels(int64_t lastDay) {
+    for (size_t l = 0; l < LEVEL_COUNT; ++l) {
+        Level& target = levels[l];
+        size_t count = static_cast<size_t>(periodOf(static_cast<Granularity>(l), lastDay * SECONDS_PER_DAY) - target.firstPeriod) + 1;
+        target.count = std::max(target.count, count);
+    }
+}
+
+// Function to map days and months from a starting day to their parent buckets
+WeatherRollup::Parents WeatherRollup::parentsFrom(size_t firstDay) const {
+    const Level& days = levels[level(Granularity::Day)];
+    const Level& weeks = levels[level(Granularity::Week)];
+    const Level& months = levels[level(Granularity::Month)];
+    const Level& years = levels[level(Granularity::Year)];
+
+    // The week and month holding firstDay are recomputed from their first day (or the first day of data)
+    int64_t start = (days.firstPeriod + static_cast<int64_t>(firstDay)) * SECONDS_PER_DAY;
+    int64_t weekStart = TimeUtils::dayNumber(periodStart(Granularity::Week, periodOf(Granularity::Week, start)));
+    int64_t monthStart = TimeUtils::dayNumber(periodStart(Granularity::Month, periodOf(Granularity::Month, start)));
+    int64_t january = floorDiv(periodOf(Granularity::Month, start), 12) * 12;
+
+    Parents parents;
+    parents.weekFromDay = static_cast<size_t>(std::max<int64_t>(weekStart - days.firstPeriod, 0));
+    parents.monthFromDay = static_cast<size_t>(std::max<int64_t>(monthStart - days.firstPeriod, 0));
+    parents.yearFromMonth = static_cast<size_t>(std::max<int64_t>(january - months.firstPeriod, 0));
+
+    size_t fromDay = std::min(parents.weekFromDay, parents.monthFromDay);
+    parents.weekOfDay.resize(days.count - fromDay);
+    parents.monthOfDay.resize(days.count - fromDay);
+    for (size_t d = fromDay; d < days.count; ++d) {
+        int64_t dayStart = (days.firstPeriod + static_cast<int64_t>(d)) * SECONDS_PER_DAY;
+        parents.weekOfDay[d - fromDay] = static_cast<size_t>(periodOf(Granularity::Week, dayStart) - weeks.firstPeriod);
+        parents.monthOfDay[d - fromDay] = static_cast<size_t>(periodOf(Granularity::Month, dayStart) - months.firstPeriod);
+    }
+    parents.yearOfMonth.resize(months.count - parents.yearFromMonth);
+    for (size_t m = parents.yearFromMonth; m < months.count; ++m) {
+        int64_t year = floorDiv(months.firstPeriod + static_cast<int64_t>(m), 12);
+        parents.yearOfMonth[m - parents.yearFromMonth] = static_cast<size_t>(year - years.firstPeriod);
+    }
+    return parents;
+}
+
+// Function to re-derive week and month buckets from days, and year buckets from months
+void WeatherRollup::rollUp(size_t slot, const Parents& parents) {
+    const std::vector<Bucket>& dayBuckets = levels[level(Granularity::Day)].columns[slot];
+    std::vector<Bucket>& weekBuckets = levels[level(Granularity::Week)].columns[slot];
+    std::vector<Bucket>& monthBuckets = levels[level(Granularity::Month)].columns[slot];
+    std::vector<Bucket>& yearBuckets = levels[level(Granularity::Year)].columns[slot];
+    weekBuckets.resize(bucketCount(Granularity::Week));
+    monthBuckets.resize(bucketCount(Granularity::Month));
+    yearBuckets.resize(bucketCount(Granularity::Year));
+
+    size_t fromDay = std::min(parents.weekFromDay, parents.monthFromDay);
+    if (fromDay < dayBuckets.size()) {
+        std::fill(weekBuckets.begin() + parents.weekOfDay[parents.weekFromDay - fromDay], weekBuckets.end(), Bucket());
+        std::fill(monthBuckets.begin() + parents.monthOfDay[parents.monthFromDay - fromDay], monthBuckets.end(), Bucket());
+    }
+    for (size_t d = fromDay; d < dayBuckets.size(); ++d) {
+        if (d >= parents.weekFromDay) {
+            weekBuckets[parents.weekOfDay[d - fromDay]].merge(dayBuckets[d]);
+        }
+        if (d >= parents.monthFromDay) {
+            monthBuckets[parents.monthOfDay[d - fromDay]].merge(dayBuckets[d]);
+        }
+    }
+
+    if (parents.yearFromMonth < monthBuckets.size()) {
+        std::fill(yearBuckets.begin() + parents.yearOfMonth[0], yearBuckets.end(), Bucket());
+    }
+    for (size_t m = parents.yearFromMonth; m < monthBuckets.size(); ++m) {
+        yearBuckets[parents.yearOfMonth[m - parents.yearFromMonth]].merge(monthBuckets[m]);
+    }
+}
+
+std::vector<size_t> WeatherRollup::builtColumns() const {
+    std::vector<size_t> columns(levels[0].columns.size());
+    for (size_t index = 0; index < columnSlots.size(); ++index) {
+        if (columnSlots[index] != -1) {
+            columns[static_cast<size_t>(columnSlots[index])] = index;
+        }
+    }
+    return columns;
+}
+
+// Function to stream one column into a t-digest per period
+std::vector<TDigest> WeatherRollup::sketches(const WeatherTable& table, size_t column, Granularity granularity,
+                                             unsigned workers) const {
+    const Level& target = levels[level(granularity)];
+    if (empty() || column >= table.columnCount() || table.empty()) {
+        return {};
+    }
+    const int64_t* timestamps = table.timestamps();
+    const double* values = table.column(column);
+
+    std::vector<std::pair<size_t, size_t>> ranges =
+        Parallel::splitRange(table.rowCount(), Parallel::workerCount(workers));
+    std::vector<std::vector<TDigest>> partial(ranges.size());
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        std::vector<TDigest>& digests = partial[worker];
+        digests.assign(target.count, TDigest());
+        std::vector<Run> runs = periodRuns(timestamps, ranges[worker].first, ranges[worker].second,
+                                           granularity, table.timestampsAscending());
+        for (const Run& run : runs) {
+            digests[static_cast<size_t>(run.period - target.firstPeriod)].add(values + run.begin, run.end - run.begin);
+        }
+    });
+
+    // Digests are mergeable, so the row blocks combine period by period
+    for (size_t worker = 1; worker < partial.size(); ++worker) {
+        for (size_t i = 0; i < target.count; ++i) {
+            partial[0][i].merge(partial[worker][i]);
+        }
+    }
+    return std::move(partial[0]);
+}
+
+// Function to cut rows into same-period runs
+std::vector<WeatherRollup::Run> WeatherRollup::periodRuns(const int64_t* timestamps, size_t begin, size_t end,
+                                                          Granularity granularity, bool ascending) {
+    std::vector<Run> runs;
+    size_t i = begin;
+    while (i < end) {
+        int64_t period = periodOf(granularity, timestamps[i]);
+        int64_t nextStart = periodStart(granularity, period + 1);
+        size_t runEnd = i + 1;
+        if (ascending) {
+            // Gallop past rows known to be in the period, then binary search the last step
+            size_t step = 1;
+            size_t probe = i + step;
+            while (probe < end && timestamps[probe] < nextStart) {
+                runEnd = probe + 1;
+                step *= 2;
+                probe = i + step;
+            }
+            size_t bound = std::min(probe, end);
+            runEnd = static_cast<size_t>(std::lower_bound(timestamps + runEnd, timestamps + bound, nextStart) - timestamps);
+        } else {
+            int64_t start = periodStart(granularity, period);
+            while (runEnd < end && timestamps[runEnd] >= start && timestamps[runEnd] < nextStart) {
+                ++runEnd;
+            }
+        }
+        runs.push_back({ i, runEnd, period });
+        i = runEnd;
+    }
+    return runs;
+}
+
+int64_t WeatherRollup::periodOf(Granularity granularity, int64_t epochSeconds) {
+    switch (granularity) {
+        case Granularity::Day:
+            return TimeUtils::dayNumber(epochSeconds);
+        case Granularity::Week:
+            // 1970-01-01 was a Thursday; week 0 starts on Monday 1969-12-29
+            return floorDiv(TimeUtils::dayNumber(epochSeconds) + 3, 7);
+        case Granularity::Month: {
+            int year = 0, month = 0, day = 0;
+            TimeUtils::toCivil(epochSeconds, year, month, day);
+            return static_cast<int64_t>(year) * 12 + (month - 1);
+        }
+        default:
+            return TimeUtils::yearOf(epochSeconds);
+    }
+}
+
+int64_t WeatherRollup::periodStart(Granularity granularity, int64_t period) {
+    switch (granularity) {
+        case Granularity::Day:
+            return period * SECONDS_PER_DAY;
+        case Granularity::Week:
+            return (period * 7 - 3) * SECONDS_PER_DAY;
+        case Granularity::Month: {
+            int64_t year = floorDiv(period, 12);
+            return TimeUtils::toEpoch(static_cast<int>(year), static_cast<int>(period - year * 12) + 1, 1);
+        }
+        default:
+            return TimeUtils::toEpoch(static_cast<int>(period), 1, 1);
+    }
+}
+
+std::string WeatherRollup::periodLabel(Granularity granularity, int64_t period) {
+    if (granularity == Granularity::Year) {
+        return std::to_string(period);
+    }
+    int year = 0, month = 0, day = 0;
+    TimeUtils::toCivil(periodStart(granularity, period), year, month, day);
+    char buffer[32];
+    if (granularity == Granularity::Month) {
+        std::snprintf(buffer, sizeof(buffer), "%d-%02d", year, month);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%d-%02d-%02d", year, month, day);
+    }
+    return buffer;
+}
+
+int WeatherRollup::periodTick(Granularity granularity, int64_t period) {
+    if (granularity == Granularity::Year) {
+        return static_cast<int>(period);
+    }
+    if (granularity == Granularity::Month) {
+        return static_cast<int>(period - floorDiv(period, 12) * 12) + 1;
+    }
+    int year = 0, month = 0, day = 0;
+    TimeUtils::toCivil(periodStart(granularity, period), year, month, day);
+    return day;
+}
+
+const char* WeatherRollup::granularityName(Granularity granularity) {
+    switch (granularity) {
+        case Granularity::Day:   return "day";
+        case Granularity::Week:  return "week";
+        case Granularity::Month: return "month";
+        default:                 return "year";
+    }
+}
+
+const char* WeatherRollup::granularityAdjective(Granularity granularity) {
+    switch (granularity) {
+        case Granularity::Day:   return "Daily";
+        case Granularity::Week:  return "Weekly";
+        case Granularity::Month: return "Monthly";
+        default:                 return "Yearly";
+    }
+}
+
+bool WeatherRollup::parseGranularity(const std::string& text, Granularity& granularity) {
+    std::string lower;
+    for (char c : text) {
+        lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    for (size_t l = 0; l < LEVEL_COUNT; ++l) {
+        Granularity candidate = static_cast<Granularity>(l);
+        std::string name = granularityName(candidate);
+        std::string adjective = granularityAdjective(candidate);
+        for (char& c : adjective) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (lower == name || lower == adjective || lower == name.substr(0, 1)) {
+            granularity = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,64 @@
+#include "WeatherSchema.h"
+
+const std::string WeatherSchema::TEMPERATURE = "temperature";
+
+WeatherSchema::WeatherSchema() {}
+
+// Function to index the header once: name -> column and (country, metric) -> column
+void WeatherSchema::build(const std::vector<std::string>& columnNames) {
+    columnIds.clear();
+    countryIds.clear();
+    metricIds.clear();
+    countryNames.clear();
+    metricNames.clear();
+    grid.clear();
+
+    // First pass: assign ids to every country and metric
+    std::vector<std::pair<int, int>> keys(columnNames.size(), std::make_pair(-1, -1));
+    for (size_t i = 0; i < columnNames.size(); ++i) {
+        const std::string& name = columnNames[i];
+        columnIds.emplace(name, static_cast<int>(i));
+
+        size_t pos = name.find('_');
+        if (pos == std::string::npos || pos == 0 || pos + 1 == name.size()) {
+            continue; // Not a "<country>_<metric>" column
+        }
+        std::string country = name.substr(0, pos);
+        std::string metric = name.substr(pos + 1);
+
+        auto countryIt = countryIds.emplace(country, static_cast<int>(countryNames.size()));
+        if (countryIt.second) {
+            countryNames.push_back(country);
+        }
+        auto metricIt = metricIds.emplace(metric, static_cast<int>(metricNames.size()));
+        if (metricIt.second) {
+            metricNames.push_back(metric);
+        }
+        keys[i] = std::make_pair(countryIt.first->second, metricIt.first->second);
+    }
+
+    // Second pass: fill the dense (country, metric) grid
+    grid.assign(countryNames.size() * metricNames.size(), -1);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i].first >= 0) {
+            grid[keys[i].first * metricNames.size() + keys[i].second] = static_cast<int>(i);
+        }
+    }
+}
+
+int WeatherSchema::columnIndex(const std::string& country, const std::string& metric) const {
+    auto countryIt = countryIds.find(country);
+    if (countryIt == countryIds.end()) {
+        return -1;
+    }
+    auto metricIt = metricIds.find(metric);
+    if (metricIt == metricIds.end()) {
+        return -1;
+    }
+    return grid[countryIt->second * metricNames.size() + metricIt->second];
+}
+
+int WeatherSchema::findColumn(const std::string& name) const {
+    auto it = columnIds.find(name);
+    return it == columnIds.end() ? -1 : it->second;
+}
@@ -0,0 +1,431 @@
+#include "WeatherTable.h"
+#include <algorithm>
+#include <mutex>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include "CSVReader.h"
+#include "CSVScanner.h"
+#include "NumberParser.h"
+#include "Parallel.h"
+#include "TimeUtils.h"
+
+namespace {
+    /**
+     * @brief Rows parsed by one worker from its byte range
+     */
+    struct ParsedChunk {
+        std::vector<int64_t> timestamps;
+        std::vector<std::vector<double>> columns;
+        std::vector<WeatherTable::ColumnStats> stats;
+        size_t skippedRows = 0;
+    };
+
+    /**
+     * @brief Parse every complete line in text[begin, end) into typed values
+     */
+    void parseChunk(std::string_view text, size_t begin, size_t end, size_t columnCount, ParsedChunk& chunk)
+    {
+        const double missing = std::numeric_limits<double>::quiet_NaN();
+        chunk.columns.resize(columnCount);
+        chunk.stats.resize(columnCount);
+
+        std::vector<std::string_view> fields;
+        size_t pos = begin;
+        while (pos < end) {
+            // One vector pass finds both the field separators and the end of the line
+            size_t lineLength = CSVScanner::splitLine(text.data() + pos, end - pos, ',', fields);
+            pos += lineLength + 1;
+            if (fields.empty()) {
+                continue; // Blank line
+            }
+
+            int64_t epoch = 0;
+            if (!TimeUtils::parseTimestamp(fields[0], epoch)) {
+                ++chunk.skippedRows; // Invalid timestamp
+                continue;
+            }
+            chunk.timestamps.push_back(epoch);
+
+            for (size_t c = 0; c < columnCount; ++c) {
+                double value = missing;
+                NumberParser::Result result = NumberParser::Result::Empty;
+                if (c + 1 < fields.size()) {
+                    result = NumberParser::parseDouble(fields[c + 1], value);
+                }
+                if (result != NumberParser::Result::Ok) {
+                    value = missing;
+                    if (result == NumberParser::Result::Empty) {
+                        ++chunk.stats[c].missing;
+                    } else {
+                        ++chunk.stats[c].invalid;
+                    }
+                }
+                chunk.columns[c].push_back(value);
+            }
+        }
+    }
+
+    /**
+     * @brief Length of the text up to and including its last newline; a line still being
+     *        written after it is left for appendNewRows
+     */
+    size_t completeLength(std::string_view text)
+    {
+        size_t lastNewline = text.rfind('\n');
+        return lastNewline == std::string_view::npos ? 0 : lastNewline + 1;
+    }
+}
+
+/**
+ * @brief What projected mode keeps to parse the remaining columns later
+ */
+struct WeatherTable::LazySource {
+    MappedFile file;
+    std::vector<size_t> rowOffsets; // Byte offset of each table row's line
+    unsigned workers = 1;
+    std::mutex mutex;               // Serialises first-time column loads
+};
+
+WeatherTable::WeatherTable()
+    : rows(0), skippedRows(0), sourceBytes(0), timestampData(nullptr), ascending(true) {}
+
+void WeatherTable::clear() {
+    columnNames.clear();
+    tableSchema.build(columnNames);
+    rows = 0;
+    stats.clear();
+    skippedRows = 0;
+    sourceBytes = 0;
+    timestampColumn.clear();
+    columns.clear();
+    lazySource.reset();
+    mappedCache.reset();
+    timestampData = nullptr;
+    ascending = true;
+    columnData.clear();
+}
+
+void WeatherTable::resetColumnViews(size_t count) {
+    std::vector<std::atomic<const double*>> views(count);
+    for (auto& view : views) {
+        view.store(nullptr, std::memory_order_relaxed);
+    }
+    columnData.swap(views);
+}
+
+void WeatherTable::useOwnedStorage() {
+    rows = timestampColumn.size();
+    timestampData = timestampColumn.data();
+    resetColumnViews(columns.size());
+    for (size_t c = 0; c < columns.size(); ++c) {
+        columnData[c].store(columns[c].data(), std::memory_order_release);
+    }
+    checkTimestampOrder();
+}
+
+void WeatherTable::checkTimestampOrder() {
+    ascending = std::is_sorted(timestampData, timestampData + rows);
+}
+
+// Function to load a CSV file into typed columns
+bool WeatherTable::load(const std::string& filename, unsigned workers) {
+    MappedCSV csv = CSVReader::mapCSV(filename);
+    if (csv.empty()) {
+        return false;
+    }
+    return loadFromCSV(csv, workers);
+}
+
+// Function to parse every row of a mapped CSV file exactly once
+bool WeatherTable::loadFromCSV(const MappedCSV& csv, unsigned workers) {
+    clear();
+
+    if (csv.empty()) {
+        std::cerr << "Error: CSV data is empty." << std::endl;
+        return false;
+    }
+
+    // Header: first column is the timestamp, every other column is numeric
+    std::vector<std::string_view> fields;
+    csv[0].split(fields);
+    for (size_t i = 1; i < fields.size(); ++i) {
+        columnNames.emplace_back(fields[i]);
+    }
+    tableSchema.build(columnNames);
+
+    // Body: split into newline-aligned byte ranges, one per worker
+    std::string_view text = csv.text();
+    text = text.substr(0, completeLength(text));
+    sourceBytes = text.size();
+    size_t bodyStart = text.find('\n');
+    bodyStart = (bodyStart == std::string_view::npos) ? text.size() : bodyStart + 1;
+    std::vector<std::pair<size_t, size_t>> ranges =
+        CSVReader::splitLines(text.substr(bodyStart), Parallel::workerCount(workers));
+
+    std::vector<ParsedChunk> chunks(ranges.size());
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        parseChunk(text, bodyStart + ranges[worker].first, bodyStart + ranges[worker].second,
+                   columnNames.size(), chunks[worker]);
+    });
+
+    // Error accounting is summed over the workers
+    stats.assign(columnNames.size(), ColumnStats());
+    for (const ParsedChunk& chunk : chunks) {
+        skippedRows += chunk.skippedRows;
+        for (size_t c = 0; c < stats.size(); ++c) {
+            stats[c].missing += chunk.stats[c].missing;
+            stats[c].invalid += chunk.stats[c].invalid;
+        }
+    }
+
+    if (chunks.size() == 1) {
+        timestampColumn = std::move(chunks[0].timestamps);
+        columns = std::move(chunks[0].columns);
+        useOwnedStorage();
+        return !empty();
+    }
+
+    // Merge in file order: each worker copies its rows to their final offset
+    std::vector<size_t> offsets(chunks.size() + 1, 0);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        offsets[i + 1] = offsets[i] + chunks[i].timestamps.size();
+    }
+    size_t total = offsets.back();
+    timestampColumn.resize(total);
+    columns.assign(columnNames.size(), std::vector<double>(total));
+
+    Parallel::run(static_cast<unsigned>(chunks.size()), [&](unsigned worker) {
+        ParsedChunk& chunk = chunks[worker];
+        std::copy(chunk.timestamps.begin(), chunk.timestamps.end(), timestampColumn.begin() + offsets[worker]);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            std::copy(chunk.columns[c].begin(), chunk.columns[c].end(), columns[c].begin() + offsets[worker]);
+            std::vector<double>().swap(chunk.columns[c]); // Release as we go
+        }
+    });
+
+    useOwnedStorage();
+    return !empty();
+}
+
+void WeatherTable::materialise() {
+    if (lazySource) {
+        for (size_t c = 0; c < columnCount(); ++c) {
+            column(c); // Parse whatever projected mode has not loaded yet
+        }
+        lazySource.reset();
+    }
+    if (mappedCache) {
+        timestampColumn.assign(timestampData, timestampData + rows);
+        columns.resize(columnCount());
+        for (size_t c = 0; c < columnCount(); ++c) {
+            const double* values = column(c);
+            columns[c].assign(values, values + rows);
+        }
+        mappedCache.reset();
+        useOwnedStorage();
+    }
+}
+
+// Function to parse only the lines appended to the CSV since the last load
+bool WeatherTable::appendNewRows(const std::string& filename, size_t& firstNewRow, unsigned workers) {
+    firstNewRow = rows;
+    if (columnNames.empty()) {
+        std::cerr << "Error: No CSV data loaded to append to." << std::endl;
+        return false;
+    }
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << "Error: Cannot open " << filename << std::endl;
+        return false;
+    }
+    if (file.size() < sourceBytes) {
+        std::cerr << "Error: " << filename << " is shorter than the data already loaded; reload it instead." << std::endl;
+        return false;
+    }
+
+    // Only complete lines; a line still being written waits for the next call
+    std::string_view text = file.text();
+    size_t lastNewline = text.rfind('\n');
+    if (lastNewline == std::string_view::npos || lastNewline + 1 <= sourceBytes) {
+        return true;
+    }
+    size_t begin = static_cast<size_t>(sourceBytes);
+    size_t end = lastNewline + 1;
+
+    materialise();
+
+    std::vector<std::pair<size_t, size_t>> ranges =
+        CSVReader::splitLines(text.substr(begin, end - begin), Parallel::workerCount(workers));
+    std::vector<ParsedChunk> chunks(ranges.size());
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        parseChunk(text, begin + ranges[worker].first, begin + ranges[worker].second, columnNames.size(), chunks[worker]);
+    });
+
+    // Appending keeps the order flag without rescanning the old rows
+    bool stillAscending = ascending;
+    int64_t previous = rows > 0 ? timestampColumn.back() : std::numeric_limits<int64_t>::min();
+    for (ParsedChunk& chunk : chunks) {
+        skippedRows += chunk.skippedRows;
+        for (size_t c = 0; c < columnNames.size(); ++c) {
+            stats[c].missing += chunk.stats[c].missing;
+            stats[c].invalid += chunk.stats[c].invalid;
+            columns[c].insert(columns[c].end(), chunk.columns[c].begin(), chunk.columns[c].end());
+        }
+        for (int64_t timestamp : chunk.timestamps) {
+            stillAscending = stillAscending && timestamp >= previous;
+            previous = timestamp;
+        }
+        timestampColumn.insert(timestampColumn.end(), chunk.timestamps.begin(), chunk.timestamps.end());
+    }
+    sourceBytes = end;
+
+    rows = timestampColumn.size();
+    timestampData = timestampColumn.data();
+    resetColumnViews(columns.size());
+    for (size_t c = 0; c < columns.size(); ++c) {
+        columnData[c].store(columns[c].data(), std::memory_order_release);
+    }
+    ascending = stillAscending;
+    return true;
+}
+
+const WeatherTable::ColumnStats& WeatherTable::columnStats(size_t index) const {
+    column(index); // Counts are only known once the column has been parsed
+    return stats[index];
+}
+
+// Function to load timestamps and a subset of columns, leaving the rest for later
+bool WeatherTable::loadProjected(const std::string& filename, const std::vector<std::string>& projection, unsigned workers) {
+    clear();
+
+    auto source = std::make_shared<LazySource>();
+    if (!source->file.open(filename) || source->file.size() == 0) {
+        return false;
+    }
+    source->workers = Parallel::workerCount(workers);
+    std::string_view text = source->file.text();
+    text = text.substr(0, completeLength(text));
+    sourceBytes = text.size();
+
+    // Header
+    std::vector<std::string_view> fields;
+    size_t headerLength = CSVScanner::splitLine(text.data(), text.size(), ',', fields);
+    for (size_t i = 1; i < fields.size(); ++i) {
+        columnNames.emplace_back(fields[i]);
+    }
+    tableSchema.build(columnNames);
+    size_t bodyStart = std::min(text.size(), headerLength + 1);
+
+    // Index rows: parse each timestamp and remember where its line starts
+    std::vector<std::pair<size_t, size_t>> ranges =
+        CSVReader::splitLines(text.substr(bodyStart), source->workers);
+    std::vector<std::vector<int64_t>> chunkTimestamps(ranges.size());
+    std::vector<std::vector<size_t>> chunkOffsets(ranges.size());
+    std::vector<size_t> chunkSkipped(ranges.size(), 0);
+
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        size_t pos = bodyStart + ranges[worker].first;
+        size_t end = bodyStart + ranges[worker].second;
+        while (pos < end) {
+            const void* nl = std::memchr(text.data() + pos, '\n', end - pos);
+            size_t lineEnd = nl ? static_cast<size_t>(static_cast<const char*>(nl) - text.data()) : end;
+            std::string_view line = text.substr(pos, lineEnd - pos);
+            size_t lineStart = pos;
+            pos = lineEnd + 1;
+
+            if (line.empty() || line == "\r") {
+                continue; // Blank line
+            }
+            int64_t epoch = 0;
+            if (!TimeUtils::parseTimestamp(line.substr(0, line.find(',')), epoch)) {
+                ++chunkSkipped[worker]; // Invalid timestamp
+                continue;
+            }
+            chunkTimestamps[worker].push_back(epoch);
+            chunkOffsets[worker].push_back(lineStart);
+        }
+    });
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        timestampColumn.insert(timestampColumn.end(), chunkTimestamps[i].begin(), chunkTimestamps[i].end());
+        source->rowOffsets.insert(source->rowOffsets.end(), chunkOffsets[i].begin(), chunkOffsets[i].end());
+        skippedRows += chunkSkipped[i];
+    }
+
+    rows = timestampColumn.size();
+    timestampData = timestampColumn.data();
+    checkTimestampOrder();
+    columns.assign(columnNames.size(), std::vector<double>());
+    stats.assign(columnNames.size(), ColumnStats());
+    resetColumnViews(columnNames.size());
+    lazySource = std::move(source);
+
+    // Parse the requested columns now; everything else waits for first use
+    for (const std::string& name : projection) {
+        int index = findColumn(name);
+        if (index != -1) {
+            column(static_cast<size_t>(index));
+        }
+    }
+    return !empty();
+}
+
+// Function to parse one column from the mapped CSV, jumping straight to its field in each row
+const double* WeatherTable::loadColumn(size_t index) const {
+    if (!lazySource) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(lazySource->mutex);
+    const double* loaded = columnData[index].load(std::memory_order_acquire);
+    if (loaded != nullptr) {
+        return loaded; // Another thread got here first
+    }
+
+    const char* data = lazySource->file.data();
+    size_t size = lazySource->file.size();
+    const std::vector<size_t>& offsets = lazySource->rowOffsets;
+    std::vector<double>& values = columns[index];
+    values.resize(rows);
+
+    std::vector<std::pair<size_t, size_t>> ranges = Parallel::splitRange(rows, lazySource->workers);
+    std::vector<ColumnStats> partial(ranges.size());
+    Parallel::run(static_cast<unsigned>(ranges.size()), [&](unsigned worker) {
+        const double missing = std::numeric_limits<double>::quiet_NaN();
+        for (size_t r = ranges[worker].first; r < ranges[worker].second; ++r) {
+            const char* line = data + offsets[r];
+            size_t remaining = size - offsets[r];
+            size_t start = CSVScanner::skipFields(line, remaining, ',', index + 1);
+
+            NumberParser::Result result = NumberParser::Result::Empty;
+            double value = missing;
+            if (start != CSVScanner::npos) {
+                size_t end = start;
+                while (end < remaining && line[end] != ',' && line[end] != '\n') {
+                    ++end;
+                }
+                result = NumberParser::parseDouble(std::string_view(line + start, end - start), value);
+            }
+            if (result != NumberParser::Result::Ok) {
+                value = missing;
+                if (result == NumberParser::Result::Empty) {
+                    ++partial[worker].missing;
+                } else {
+                    ++partial[worker].invalid;
+                }
+            }
+            values[r] = value;
+        }
+    });
+
+    ColumnStats total;
+    for (const ColumnStats& part : partial) {
+        total.missing += part.missing;
+        total.invalid += part.invalid;
+    }
+    stats[index] = total;
+
+    columnData[index].store(values.data(), std::memory_order_release);
+    return values.data();
+}
@@ -1,7 +1,108 @@
 #include "MerkelMain.h"
 
-int main() {
-    MerkelMain app;
-    app.init();
-    return 0;
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "BatchQuery.h"
+
+namespace {
+    void printUsage(const char* program)
+    {
+        std::cout << "Usage: " << program << " [-d DATA.csv] [-j WORKERS] [-f QUERIES|-] [QUERY[; QUERY...]]\n"
+                  << "       " << program << " [-d DATA.csv] [-j WORKERS] -s SOCKET [-t THREADS]\n"
+                  << "Without queries the interactive menu starts. With -s the data stays loaded and each\n"
+                  << "query line sent to the Unix socket is answered with one JSON line.\n"
+                  << "Queries (one per line in a file, '#' comments):\n"
+                  << "  candles  CC [year|month|week|day]\n"
+                  << "  hist     CC [mean|max|min|median|pN] [year|month|week|day]\n"
+                  << "  forecast CC N [year|month|week|day] [linear|hw|arima|best]\n"
+                  << "  window   CC YYYY-MM-DD[THH:MM:SS] YYYY-MM-DD[THH:MM:SS]\n"
+                  << "Example: " << program << " \"candles DE yearly; hist FR max; forecast GB 10\"\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataFilename = "../weather_data.csv";
+    unsigned workers = 0;
+    bool batch = false;
+    std::string socketPath;
+    unsigned serverThreads = 0;
+    std::vector<std::string> queries;
+    std::string words;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if ((arg == "-d" || arg == "--data") && hasValue) {
+            dataFilename = argv[++i];
+        } else if ((arg == "-j" || arg == "--jobs") && hasValue) {
+            workers = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if ((arg == "-s" || arg == "--serve") && hasValue) {
+            socketPath = argv[++i];
+        } else if ((arg == "-t" || arg == "--threads") && hasValue) {
+            serverThreads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if ((arg == "-f" || arg == "--file") && hasValue) {
+            // Query file, or "-" for standard input
+            std::string path = argv[++i];
+            std::ifstream file;
+            if (path != "-") {
+                file.open(path);
+                if (!file) {
+                    std::cerr << "Error: Could not open query file " << path << std::endl;
+                    return 2;
+                }
+            }
+            std::istream& in = (path == "-") ? std::cin : file;
+            std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            for (const std::string& query : BatchQuery::split(text)) {
+                queries.push_back(query);
+            }
+            batch = true;
+        } else if (!arg.empty() && arg[0] == '-' && arg.size() > 1) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            // Remaining words form queries, separated by ';'
+            words += (words.empty() ? "" : " ") + arg;
+            batch = true;
+        }
+    }
+    for (const std::string& query : BatchQuery::split(words)) {
+        queries.push_back(query);
+    }
+
+    if (!socketPath.empty() && batch) {
+        std::cerr << "Error: Queries cannot be combined with -s." << std::endl;
+        return 2;
+    }
+
+    // Countries the batch names, so a start without a fresh cache can parse only their columns
+    std::vector<std::string> countries;
+    for (const std::string& query : queries) {
+        BatchQuery parsed;
+        std::string error;
+        if (BatchQuery::parse(query, parsed, error) &&
+            std::find(countries.begin(), countries.end(), parsed.country) == countries.end()) {
+            countries.push_back(parsed.country);
+        }
+    }
+
+    MerkelMain app(workers, dataFilename, countries);
+    if (!socketPath.empty()) {
+        return app.serve(socketPath, serverThreads) ? 0 : 1;
+    }
+    if (!batch) {
+        app.init();
+        return 0;
+    }
+    return app.runBatch(queries) == 0 ? 0 : 1;
 }